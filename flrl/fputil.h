@@ -16,6 +16,9 @@
 
 extern bool floats_equalish(double a, double b, double epsilon, double abs_th);
 
+/* compensated sums, spread over this many vectors of accumulators */
+#define FPUTIL_KBN_SUM_VECS (4U)
+
 extern double kbn_sumf32v(const float *values, size_t n_values);
 extern double kbn_sumf64v(const double *values, size_t n_values);
 
@@ -43,6 +46,48 @@ inline void kbn_sumf64_r(double *sum, double *comp, double addend)
     noinline_kbn_sumf64_r(sum, comp, addend);
 #endif
 
+/* Knuth's TwoSum: the same sum and compensation as kbn_sumf64_r(), but
+ * found without comparing magnitudes.  it needs no branches or math
+ * functions, so it's inlined in c++ too, and loops over independent
+ * accumulators vectorise.
+ */
+inline void two_sumf64_r(double *sum, double *comp, double addend)
+{
+    const double s = *sum, t = s + addend, bp = t - s;
+
+    *comp += (s - (t - bp)) + (addend - bp);
+    *sum = t;
+}
+
+/* two_sumf64_r() on both lanes of a vector.  compensated sums spread over
+ * a few of these are independent, so they don't wait on each other like
+ * a single chain does.  kbn_sumf64x2_r() then adds n_vecs of them, with
+ * their compensations, into a scalar sum and compensation.
+ */
+typedef double fputil_f64x2 __attribute__((vector_size(16)));
+
+inline void two_sumf64x2_r(fputil_f64x2 *sum, fputil_f64x2 *comp,
+                           fputil_f64x2 addend)
+{
+    const fputil_f64x2 s = *sum, t = s + addend, bp = t - s;
+
+    *comp += (s - (t - bp)) + (addend - bp);
+    *sum = t;
+}
+
+inline void kbn_sumf64x2_r(double *sum, double *comp,
+                           const fputil_f64x2 *sums, const fputil_f64x2 *comps,
+                           size_t n_vecs)
+{
+    size_t v;
+
+    for (v = 0; v < n_vecs; v++) {
+        two_sumf64_r(sum, comp, sums[v][0]);
+        two_sumf64_r(sum, comp, sums[v][1]);
+        *comp += comps[v][0] + comps[v][1];
+    }
+}
+
 extern double niceceil(double x);
 extern double nicefloor(double x);
 
@@ -0,0 +1,37 @@
+#ifndef LIBFLRL_PARALLEL_H
+#define LIBFLRL_PARALLEL_H
+
+#include "flrl/flrl.h"
+
+#include <stddef.h>
+
+/* fork-join helper for splitting array work across threads.
+ *
+ * parallel_for() splits [0, n_items) into contiguous chunks, calls
+ * fn(arg, chunk, begin, end) once per chunk, and returns once they have
+ * all finished.  chunk numbers run from 0, in item order, so callers that
+ * need deterministic results can keep per-chunk partial results and
+ * combine them in chunk order afterwards.  the calling thread runs chunk
+ * 0 itself, and runs any chunk whose thread couldn't be started, so the
+ * work is always done even if thread creation fails.
+ *
+ * n_threads is the most threads to use, or 0 for one per online cpu.
+ * chunks are made no smaller than min_chunk items (except a lone chunk
+ * when n_items is smaller), so small inputs don't pay for threads.
+ * parallel_chunks() returns how many chunks parallel_for() will use for
+ * the same arguments, e.g. to size an array of partial results.
+ */
+typedef void (parallel_fn)(void *arg, unsigned chunk,
+                           size_t begin, size_t end);
+
+extern unsigned parallel_ncpu(void);
+extern unsigned parallel_chunks(unsigned n_threads,
+                                size_t n_items,
+                                size_t min_chunk);
+extern void parallel_for(unsigned n_threads,
+                         size_t n_items,
+                         size_t min_chunk,
+                         parallel_fn *fn,
+                         void *arg);
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef LIBFLRL_PHILOX_H
+#define LIBFLRL_PHILOX_H
+
+#include "flrl/flrl.h"
+#include "flrl/randutil.h"
+
+#include <stdint.h>
+
+/* Philox4x32-10, the counter-based generator from Salmon et al., "Parallel
+ * Random Numbers: As Easy as 1, 2, 3" (SC '11).  each 128-bit output block
+ * is a keyed bijection of a 128-bit counter, so any block can be computed
+ * directly from (key, counter) without generating the ones before it.
+ * it passes BigCrush, and its outputs match the Random123 reference
+ * implementation.
+ *
+ * philox4x32_10() encrypts the counter block ctr in place.
+ */
+#define PHILOX_M4x32_0 (UINT32_C(0xd2511f53))
+#define PHILOX_M4x32_1 (UINT32_C(0xcd9e8d57))
+#define PHILOX_W32_0   (UINT32_C(0x9e3779b9))
+#define PHILOX_W32_1   (UINT32_C(0xbb67ae85))
+
+static inline void philox4x32_10(uint32_t ctr[4], const uint32_t key[2])
+{
+    uint32_t k0 = key[0], k1 = key[1];
+    unsigned r;
+
+    for (r = 0; r < 10; r++) {
+        const uint64_t p0 = (uint64_t) PHILOX_M4x32_0 * ctr[0];
+        const uint64_t p1 = (uint64_t) PHILOX_M4x32_1 * ctr[2];
+        const uint32_t c1 = ctr[1], c3 = ctr[3];
+
+        ctr[0] = (uint32_t) (p1 >> 32) ^ c1 ^ k0;
+        ctr[1] = (uint32_t) p1;
+        ctr[2] = (uint32_t) (p0 >> 32) ^ c3 ^ k1;
+        ctr[3] = (uint32_t) p0;
+
+        k0 += PHILOX_W32_0;
+        k1 += PHILOX_W32_1;
+    }
+}
+
+/* as a randbs generator, the state holds a 64-bit counter of 32-bit output
+ * words in s[0] (low half) and s[1], and the 64-bit key in s[2] (low half)
+ * and s[3].  output word w is word w % 4 of the block for counter w / 4,
+ * so a stream can be positioned anywhere by setting the counter, and
+ * streams with different keys are independent.  every call computes a
+ * whole block for one word, so bulk users that can keep the rest of the
+ * block, such as the *_parallel fills in randutil.h, are faster than a
+ * stream of individual calls.
+ *
+ * unlike the xoshiro generators, any state is valid, including zero.
+ */
+extern uint32_t philox4x32_next(struct state128 *state);
+
+/* inlinable body of philox4x32_next() */
+static inline uint32_t philox4x32_next_inline(struct state128 *state)
+{
+    const uint64_t w = state->s[0] | (uint64_t) state->s[1] << 32;
+    const uint32_t key[2] = { state->s[2], state->s[3] };
+    uint32_t ctr[4] = { (uint32_t) (w >> 2), (uint32_t) (w >> 34), 0, 0 };
+
+    philox4x32_10(ctr, key);
+
+    state->s[0] = (uint32_t) (w + 1);
+    state->s[1] = (uint32_t) ((w + 1) >> 32);
+
+    return ctr[w & 3];
+}
+
+/* sets state to word counter of the stream with the given key */
+static inline void philox4x32_state(struct state128 *state,
+                                    uint64_t key, uint64_t counter)
+{
+    state->s[0] = (uint32_t) counter;
+    state->s[1] = (uint32_t) (counter >> 32);
+    state->s[2] = (uint32_t) key;
+    state->s[3] = (uint32_t) (key >> 32);
+}
+
+#endif
@@ -11,8 +11,11 @@
  #define restrict
  using std::size_t;
  extern double randutil_fma(double x, double y, double z);
+ extern double randutil_exp(double x);
  extern double randutil_log(double x);
  extern double randutil_sqrt(double x);
+ extern double randutil_log1p(double x);
+ extern double randutil_expm1(double x);
 #endif
 
 struct state128 {
@@ -49,11 +52,75 @@ inline void state256_seed64(struct state256 *state, uint64_t seed)
     state_seed_sm64(state, sizeof(*state), seed);
 }
 
+/* how randi*v()/randu*v() map random bits onto [min, max]:
+ *
+ * RANDBS_INT_MASK: draw bit_width(max - min) bits, and retry if the result
+ *   is out of range.  uses the fewest bits, but retries up to half the time
+ *   for ranges just above a power of two.
+ *
+ * RANDBS_INT_LEMIRE: Lemire's nearly divisionless multiply-shift method.
+ *   draws 32 bits (64 bits for ranges wider than 32 bits) per value, and
+ *   almost never retries.
+ *
+ * both are unbiased.  ranges whose size is a power of two never retry, and
+ * are done by masking either way.
+ */
+enum randbs_int_method {
+    RANDBS_INT_MASK = 0,
+    RANDBS_INT_LEMIRE,
+};
+
+/* how gaussf32v()/gaussf64v() and friends make normal deviates:
+ *
+ * RANDBS_GAUSS_POLAR: Marsaglia's polar method.  makes deviates in pairs
+ *   from two uniform floats, and needs a log and a sqrt for each pair.  an
+ *   unused second deviate is kept in the stream for the next call, so
+ *   single-value calls cost half a pair each, and the sequence is the same
+ *   however it's split into calls.
+ *
+ * RANDBS_GAUSS_ZIGGURAT: Marsaglia and Tsang's ziggurat method, with 256
+ *   precomputed layers.  about 99% of deviates come from a single draw, a
+ *   multiply and a compare; the rest need an exp or log.
+ */
+enum randbs_gauss_method {
+    RANDBS_GAUSS_POLAR = 0,
+    RANDBS_GAUSS_ZIGGURAT,
+};
+
+/* how randf32v()/randf64v() and friends make uniform floats:
+ *
+ * RANDBS_FLOAT_PRECISE: Downey's method.  picks the exponent by counting
+ *   leading zero bits and then a full random mantissa, so every float in
+ *   [0, 1] is reachable with the right probability, including the tiny
+ *   ones near 0: about 2^30 distinct floats and 2^62 doubles.  needs a
+ *   variable number of bits and a loop per value.
+ *
+ * RANDBS_FLOAT_FAST: the usual (x >> 11) * 0x1p-53, i.e. a random 53-bit
+ *   (24-bit for floats) fixed-point fraction in [0, 1), taken from the high
+ *   bits of whole generator outputs.  only 2^53 (2^24) evenly spaced
+ *   values are reachable, so values below 2^-53 (2^-24) come out as 0, and
+ *   low-order bits of small values are always zero.  about three times
+ *   faster with the generator inlined (e.g. randf64v_xoshiro128plusplus),
+ *   where the conversion loop vectorizes; through func, the calls dominate.
+ *   scaling to [min, max) can round up to max.
+ *
+ * the polar gauss method draws its uniforms this way too.
+ */
+enum randbs_float_method {
+    RANDBS_FLOAT_PRECISE = 0,
+    RANDBS_FLOAT_FAST,
+};
+
 struct randbs {
     struct state128 state;
     uint32_t (*func)(struct state128 *);
     uint64_t bits;
     unsigned n_bits;
+    enum randbs_int_method int_method;
+    enum randbs_float_method float_method;
+    enum randbs_gauss_method gauss_method;
+    bool has_gauss_spare;
+    double gauss_spare;
 } __attribute__((aligned(64)));
 #define RANDBS_INITIALIZER(f) (struct randbs){ .func = f }
 #define RANDBS_MAX_BITS (64U)
@@ -62,22 +129,78 @@ inline void randbs_seed(struct randbs *bs, const struct state128 *seed)
 {
     state128_seed(&bs->state, seed);
     bs->bits = bs->n_bits = 0;
+    bs->has_gauss_spare = false;
 }
 
 inline void randbs_seed64(struct randbs *bs, uint64_t seed)
 {
     state128_seed64(&bs->state, seed);
     bs->bits = bs->n_bits = 0;
+    bs->has_gauss_spare = false;
 }
 
 extern uint64_t randbs_bits(struct randbs *bs, unsigned want_bits);
 extern unsigned randbs_zeroes(struct randbs *bs, unsigned limit);
 
+/* fills buf with len random bytes.  whole bytes still in the bit buffer
+ * are used first, and then single bytes up to word alignment.  the bulk is
+ * stored a generator word at a time, in native byte order, without going
+ * through the bit buffer, and the last few bytes come through it, leaving
+ * any spare bits there.
+ *
+ * from RANDBS_FILL_LANES_MIN bytes, streams using xoshiro128plusplus_next
+ * (xoshiro256plusplus_next for wrandbs_fill()) are filled by interleaved
+ * lanes instead, as in randx8: the stream draws a 64-bit seed (two words,
+ * or one for wrandbs_fill()), the lanes are seeded from it as by
+ * randx8_seed64(), and the stream carries on after the seed.  this is
+ * several times faster, but the bytes differ from what the stream would
+ * have produced one word at a time.  the lanes don't start on the stream's
+ * own jumps, so a fill from one stream of a pool doesn't reproduce the
+ * streams after it.
+ */
+#define RANDBS_FILL_LANES_MIN (4096U)
+
+extern void randbs_fill(struct randbs *bs, void *buf, size_t len);
+
+/* uniform value in [0, bound), using Lemire's method regardless of
+ * bs->int_method.  bound must not be zero. */
+extern uint32_t randbs_below32(struct randbs *bs, uint32_t bound);
+extern uint64_t randbs_below64(struct randbs *bs, uint64_t bound);
+
+/* bulk generator: eight interleaved xoshiro128++ states, stored lane-major
+ * so that each state word is one 256-bit vector (AVX2), two 128-bit vectors
+ * (SSE2/NEON), or half a 512-bit vector.  lane 0 is seeded directly, and
+ * each following lane is the previous one advanced by
+ * xoshiro128plusplus_jump(), so the lanes never overlap.
+ *
+ * the output is the lanes' outputs interleaved, i.e. word i comes from lane
+ * i % RANDX8_LANES.  leftover words from a partial block are kept in buf,
+ * so the sequence does not depend on how callers split their requests.
+ */
+#define RANDX8_LANES (8U)
+struct randx8 {
+    uint32_t s[4][RANDX8_LANES];
+    uint32_t buf[RANDX8_LANES];
+    unsigned n_buf;
+} __attribute__((aligned(64)));
+
+extern void randx8_seed(struct randx8 *restrict bs,
+                        const struct state128 *restrict seed);
+extern void randx8_seed64(struct randx8 *bs, uint64_t seed);
+
+extern void randx8_u32v(struct randx8 *bs, uint32_t *out, size_t count);
+extern void randx8_u64v(struct randx8 *bs, uint64_t *out, size_t count);
+
 struct wrandbs {
     struct state256 state;
     uint64_t (*func)(struct state256 *);
     uint64_t bits;
     unsigned n_bits;
+    enum randbs_int_method int_method;
+    enum randbs_float_method float_method;
+    enum randbs_gauss_method gauss_method;
+    bool has_gauss_spare;
+    double gauss_spare;
 } __attribute__((aligned(64)));
 #define WRANDBS_INITIALIZER(f) (struct wrandbs){ .func = f }
 #define WRANDBS_MAX_BITS (64U)
@@ -86,17 +209,21 @@ inline void wrandbs_seed(struct wrandbs *bs, const struct state256 *seed)
 {
     state256_seed(&bs->state, seed);
     bs->bits = bs->n_bits = 0;
+    bs->has_gauss_spare = false;
 }
 
 inline void wrandbs_seed64(struct wrandbs *bs, uint64_t seed)
 {
     state256_seed64(&bs->state, seed);
     bs->bits = bs->n_bits = 0;
+    bs->has_gauss_spare = false;
 }
 
 extern uint64_t wrandbs_bits(struct wrandbs *bs, unsigned want_bits);
 extern unsigned wrandbs_zeroes(struct wrandbs *bs, unsigned limit);
 
+extern void wrandbs_fill(struct wrandbs *bs, void *buf, size_t len);
+
 extern void randi8v(struct randbs *bs,
                     int8_t *out,
                     size_t count,
@@ -236,22 +363,320 @@ extern void gaussf64v(struct randbs *bs,
 
 extern double gaussf64(struct randbs *bs, double mean, double stddev);
 
+/* other distributions, all drawn through the same bit buffer as above:
+ *
+ * exponential*v(): exponential with the given mean, by ziggurat.
+ * poisson*v(): Poisson with the given mean, by inversion for means below 10
+ *   and by Hormann's PTRS transformed rejection above.
+ * binomial*v(): successes in n trials with success probability p, by BTPE
+ *   when n * min(p, 1 - p) >= 30 and by inversion below.
+ * geometric*v(): failures before the first success, with success
+ *   probability p in (0, 1].
+ * zipf*v(): k in [1, n] with probability proportional to k^-s, for s >= 0,
+ *   by rejection-inversion.  takes O(1) time and memory for any n, so it
+ *   suits skewed key workloads: rank k can index a table of keys.
+ *
+ * integer results saturate at the type's max.  setup costs are paid once
+ * per call, so filling many values at once is cheaper than one at a time.
+ */
+extern void exponentialf32v(struct randbs *bs,
+                            float *out,
+                            size_t count,
+                            double mean);
+
+extern void exponentialf64v(struct randbs *bs,
+                            double *out,
+                            size_t count,
+                            double mean);
+
+extern void poissonu32v(struct randbs *bs,
+                        uint32_t *out,
+                        size_t count,
+                        double mean);
+
+extern void poissonu64v(struct randbs *bs,
+                        uint64_t *out,
+                        size_t count,
+                        double mean);
+
+extern void binomialu32v(struct randbs *bs,
+                         uint32_t *out,
+                         size_t count,
+                         uint32_t n,
+                         double p);
+
+extern void binomialu64v(struct randbs *bs,
+                         uint64_t *out,
+                         size_t count,
+                         uint64_t n,
+                         double p);
+
+extern void geometricu32v(struct randbs *bs,
+                          uint32_t *out,
+                          size_t count,
+                          double p);
+
+extern void geometricu64v(struct randbs *bs,
+                          uint64_t *out,
+                          size_t count,
+                          double p);
+
+extern void zipfu32v(struct randbs *bs,
+                     uint32_t *out,
+                     size_t count,
+                     uint32_t n,
+                     double s);
+
+extern void zipfu64v(struct randbs *bs,
+                     uint64_t *out,
+                     size_t count,
+                     uint64_t n,
+                     double s);
+
+/* variants of the above with the generator fixed at compile time, e.g.
+ * randu32v_xoshiro128plusplus(), so that it can be inlined into the engine
+ * loops rather than called through bs->func.  the stream must have been set
+ * up with the matching generator, e.g.
+ * RANDBS_INITIALIZER(xoshiro128plusplus_next).  the stream is consumed the
+ * same way as by the generic functions, so calls can be mixed freely.
+ */
+#define RANDBS_GEN_DECLARE(gen)                                             \
+    extern void randi8v_##gen(struct randbs *bs, int8_t *out, size_t count, \
+                              int8_t min, int8_t max);                      \
+    extern void randi16v_##gen(struct randbs *bs, int16_t *out,             \
+                               size_t count, int16_t min, int16_t max);     \
+    extern void randi32v_##gen(struct randbs *bs, int32_t *out,             \
+                               size_t count, int32_t min, int32_t max);     \
+    extern void randi64v_##gen(struct randbs *bs, int64_t *out,             \
+                               size_t count, int64_t min, int64_t max);     \
+    extern void randu8v_##gen(struct randbs *bs, uint8_t *out,              \
+                              size_t count, uint8_t min, uint8_t max);      \
+    extern void randu16v_##gen(struct randbs *bs, uint16_t *out,            \
+                               size_t count, uint16_t min, uint16_t max);   \
+    extern void randu32v_##gen(struct randbs *bs, uint32_t *out,            \
+                               size_t count, uint32_t min, uint32_t max);   \
+    extern void randu64v_##gen(struct randbs *bs, uint64_t *out,            \
+                               size_t count, uint64_t min, uint64_t max);   \
+    extern void randf32v_##gen(struct randbs *bs, float *out, size_t count, \
+                               double min, double max);                     \
+    extern void randf64v_##gen(struct randbs *bs, double *out,              \
+                               size_t count, double min, double max);       \
+    extern void gaussf32v_##gen(struct randbs *bs, float *out,              \
+                                size_t count, double mean, double stddev);  \
+    extern void gaussf64v_##gen(struct randbs *bs, double *out,             \
+                                size_t count, double mean, double stddev);
+
+RANDBS_GEN_DECLARE(xoshiro128plus)
+RANDBS_GEN_DECLARE(xoshiro128plusplus)
+RANDBS_GEN_DECLARE(xoshiro128starstar)
+RANDBS_GEN_DECLARE(philox4x32)
+
+/* parallel fills, for streams using the counter-based philox4x32_next
+ * generator (see flrl/philox.h).  out is cut into segments of
+ * RANDBS_PARALLEL_SEGMENT elements, and segment s is filled just as the
+ * serial fill (randi16v() for randi16v_parallel(), and so on) would fill it
+ * from a stream RANDBS_PARALLEL_STRIDE words past bs's position, times s.
+ * so out only depends on bs's key and position and bs's method settings:
+ * never on n_threads or on how the work was split.  a large array can be
+ * filled in pieces of whole segments by advancing the counter of bs by
+ * RANDBS_PARALLEL_STRIDE per segment between calls.  bs itself is not
+ * advanced, and its buffered bits and gauss spare are not used.
+ *
+ * n_threads is as for parallel_for() in flrl/parallel.h: 0 means one per
+ * cpu.
+ */
+#define RANDBS_PARALLEL_SEGMENT (4096U)
+#define RANDBS_PARALLEL_STRIDE (UINT64_C(1) << 32)
+
+#define RANDBS_PARALLEL_DECLARE_RANDIV(name, T)                             \
+    extern void name##_parallel(const struct randbs *bs, T *out,            \
+                                size_t count, T min, T max,                 \
+                                unsigned n_threads);
+
+RANDBS_PARALLEL_DECLARE_RANDIV(randi8v, int8_t)
+RANDBS_PARALLEL_DECLARE_RANDIV(randi16v, int16_t)
+RANDBS_PARALLEL_DECLARE_RANDIV(randi32v, int32_t)
+RANDBS_PARALLEL_DECLARE_RANDIV(randi64v, int64_t)
+RANDBS_PARALLEL_DECLARE_RANDIV(randu8v, uint8_t)
+RANDBS_PARALLEL_DECLARE_RANDIV(randu16v, uint16_t)
+RANDBS_PARALLEL_DECLARE_RANDIV(randu32v, uint32_t)
+RANDBS_PARALLEL_DECLARE_RANDIV(randu64v, uint64_t)
+
+extern void randf32v_parallel(const struct randbs *bs, float *out,
+                              size_t count, double min, double max,
+                              unsigned n_threads);
+extern void randf64v_parallel(const struct randbs *bs, double *out,
+                              size_t count, double min, double max,
+                              unsigned n_threads);
+extern void gaussf32v_parallel(const struct randbs *bs, float *out,
+                               size_t count, double mean, double stddev,
+                               unsigned n_threads);
+extern void gaussf64v_parallel(const struct randbs *bs, double *out,
+                               size_t count, double mean, double stddev,
+                               unsigned n_threads);
+
 inline bool coin(struct randbs *bs, float p_true)
 {
     return randf32(bs, 0.0, 1.0) <= p_true;
 }
 
+/* coin() makes a whole randf32() for one decision.  coin_fixed() instead
+ * compares 32 random bits with a fixed-point threshold, made once by
+ * coin_threshold(), so p_true is resolved to the nearest 2^-32 below it.
+ * coin_threshold(1.0) is 2^32, which always comes up true.
+ */
+inline uint64_t coin_threshold(double p_true)
+{
+    if (!(p_true > 0.0)) return 0;
+    if (p_true >= 1.0) return UINT64_C(1) << 32;
+    return (uint64_t) (p_true * 0x1p32);
+}
+
+inline bool coin_fixed(struct randbs *bs, uint64_t threshold)
+{
+    return randbs_bits(bs, 32) < threshold;
+}
+
+/* sets the first n_bits bits of mask (bit i being bit i % 64 of mask[i /
+ * 64]) to independent Bernoulli(p_true) bits, and clears the rest of the
+ * last word.  64 lanes at a time compare a uniform, drawn one binary digit
+ * per lane per 64-bit word, with the digits of p_true: about 8 words for
+ * 64 bits, fewer if p_true is a short binary fraction (0.5 takes one).
+ * p_true is resolved to 2^-64.
+ */
+extern void bernoulli_mask(struct randbs *bs,
+                           uint64_t *mask,
+                           size_t n_bits,
+                           double p_true);
+
+/* uniform random permutation of the n_elems elements at base, by
+ * Fisher-Yates.  4, 8 and 16-byte elements are swapped directly, other
+ * sizes through a small stack buffer.
+ */
 extern void shuffle(struct randbs *rbs,
                     void *base,
                     size_t n_elems,
                     size_t elem_size);
 
+/* shuffle for arrays too big for cache.  arrays of at least
+ * SHUFFLE_PARALLEL_MIN_BYTES are split into cache-sized blocks which are
+ * shuffled independently, then merged pairwise, level by level, with
+ * MergeShuffle's merge (https://arxiv.org/abs/1508.03167), so most memory
+ * accesses are sequential.  blocks and the merges of each level are spread
+ * over up to n_threads threads (0 for one per cpu).
+ *
+ * only 64 bits are drawn from rbs, as the key of a Philox stream for each
+ * block and merge.  the result depends on rbs and the block size but not
+ * on n_threads.  smaller arrays are just passed to shuffle().
+ * shuffle_blocked() is the same with an explicit block size, in elements,
+ * and no size threshold.
+ */
+#define SHUFFLE_PARALLEL_MIN_BYTES (4U * 1024U * 1024U)
+
+extern void shuffle_parallel(struct randbs *rbs,
+                             void *base,
+                             size_t n_elems,
+                             size_t elem_size,
+                             unsigned n_threads);
+extern void shuffle_blocked(struct randbs *rbs,
+                            void *base,
+                            size_t n_elems,
+                            size_t elem_size,
+                            size_t block_elems,
+                            unsigned n_threads);
+
+/* weighted sampling by binary search of a cumulative distribution.  cheap
+ * to (re)build, O(log n) to sample.  weights are read from the unsigned
+ * (uint64_t for the 64-bit variants) at weight_offset within each element.
+ * the total weight must fit in the cdf's type, and must not be zero.
+ */
 extern void init_cdf(unsigned *cdf,
                      const void *base, size_t n_elems, size_t elem_size,
                      size_t weight_offset);
 extern unsigned sample_cdf(struct randbs *bs,
                            const unsigned *cdf, size_t n_elems);
 
+extern void init_cdf64(uint64_t *cdf,
+                       const void *base, size_t n_elems, size_t elem_size,
+                       size_t weight_offset);
+extern size_t sample_cdf64(struct randbs *bs,
+                           const uint64_t *cdf, size_t n_elems);
+
+/* weighted sampling by Walker's alias method, with Vose's construction.
+ * O(n) to build, O(1) to sample, so better than a cdf for large n unless
+ * the weights change often.  each sample picks a column uniformly, then
+ * keeps the column's own index with probability threshold / 2^32, or takes
+ * its alias otherwise.
+ *
+ * weights are read from the uint64_t (alias_init_u64) or double
+ * (alias_init_f64) at weight_offset within each element.  weights must be
+ * finite and non-negative, with a nonzero total, and n_elems must fit in
+ * 32 bits.  returns 0 on success, or -1 if memory allocation fails.
+ */
+struct alias_entry {
+    uint32_t threshold;
+    uint32_t alias;
+};
+
+struct alias_table {
+    size_t n_elems;
+    struct alias_entry *entries;
+};
+
+extern int alias_init_u64(struct alias_table *at,
+                          const void *base, size_t n_elems, size_t elem_size,
+                          size_t weight_offset);
+extern int alias_init_f64(struct alias_table *at,
+                          const void *base, size_t n_elems, size_t elem_size,
+                          size_t weight_offset);
+extern void alias_fini(struct alias_table *at);
+
+extern unsigned alias_sample(struct randbs *bs, const struct alias_table *at);
+extern void alias_samplev(struct randbs *bs, const struct alias_table *at,
+                          unsigned *out, size_t count);
+
+/* sampling without replacement: k distinct indices from [0, n), each of
+ * the n-choose-k subsets equally likely.  k must not exceed n.
+ *
+ * sample_floyd(): Floyd's algorithm.  k draws and O(k) time and memory,
+ *   however big n is, so it's the one to use when k is much smaller than
+ *   n.  the indices come out in no particular order (shuffle() them if
+ *   order matters).  returns 0 on success, or -1 if memory allocation
+ *   fails.
+ *
+ * sample_selection(): selection sampling (Knuth's Algorithm S).  walks
+ *   [0, n) once, deciding each index with one draw, so O(n) time but no
+ *   extra memory, and the indices come out in increasing order.
+ */
+extern int sample_floyd(struct randbs *bs,
+                        uint64_t *out, size_t k, uint64_t n);
+extern void sample_selection(struct randbs *bs,
+                             uint64_t *out, size_t k, uint64_t n);
+
+/* reservoir sampling of k items from a stream of unknown length, by Li's
+ * Algorithm L: after the reservoir fills, the gap to the next item to keep
+ * is drawn directly, so only O(k log(n/k)) draws are made for n items.
+ *
+ * for each item in turn, reservoir_offer() returns the reservoir slot, in
+ * [0, k), to store it in, or RESERVOIR_SKIP if it isn't kept.  the first
+ * k items go to slots 0 to k-1.  r->next is the index of the next item
+ * that will be kept, so callers may skip straight to it (e.g. seek in a
+ * file) instead of offering every item; the skipped ones must still be
+ * counted with reservoir_skip().  after n items, min(k, n) slots are
+ * filled with a uniform sample of them.
+ */
+struct reservoir {
+    size_t k;
+    uint64_t n_seen;
+    uint64_t next;
+    double w;
+};
+#define RESERVOIR_SKIP (SIZE_MAX)
+
+extern void reservoir_init(struct reservoir *r, size_t k);
+extern size_t reservoir_offer(struct reservoir *r, struct randbs *bs);
+extern void reservoir_skip(struct reservoir *r, uint64_t n_items);
+
 extern void wrandi32v(struct wrandbs *bs,
                       int32_t *out,
                       size_t count,
@@ -341,9 +766,191 @@ extern void wgaussf64v(struct wrandbs *bs,
 
 extern double wgaussf64(struct wrandbs *bs, double mean, double stddev);
 
+extern void wexponentialf32v(struct wrandbs *bs,
+                             float *out,
+                             size_t count,
+                             double mean);
+
+extern void wexponentialf64v(struct wrandbs *bs,
+                             double *out,
+                             size_t count,
+                             double mean);
+
+extern void wpoissonu32v(struct wrandbs *bs,
+                         uint32_t *out,
+                         size_t count,
+                         double mean);
+
+extern void wpoissonu64v(struct wrandbs *bs,
+                         uint64_t *out,
+                         size_t count,
+                         double mean);
+
+extern void wbinomialu32v(struct wrandbs *bs,
+                          uint32_t *out,
+                          size_t count,
+                          uint32_t n,
+                          double p);
+
+extern void wbinomialu64v(struct wrandbs *bs,
+                          uint64_t *out,
+                          size_t count,
+                          uint64_t n,
+                          double p);
+
+extern void wgeometricu32v(struct wrandbs *bs,
+                           uint32_t *out,
+                           size_t count,
+                           double p);
+
+extern void wgeometricu64v(struct wrandbs *bs,
+                           uint64_t *out,
+                           size_t count,
+                           double p);
+
+extern void wzipfu32v(struct wrandbs *bs,
+                      uint32_t *out,
+                      size_t count,
+                      uint32_t n,
+                      double s);
+
+extern void wzipfu64v(struct wrandbs *bs,
+                      uint64_t *out,
+                      size_t count,
+                      uint64_t n,
+                      double s);
+
+/* wide equivalents of RANDBS_GEN_DECLARE(), for the xoshiro256 family, e.g.
+ * wrandu64v_xoshiro256plusplus() with
+ * WRANDBS_INITIALIZER(xoshiro256plusplus_next)
+ */
+#define WRANDBS_GEN_DECLARE(gen)                                            \
+    extern void wrandi32v_##gen(struct wrandbs *bs, int32_t *out,           \
+                                size_t count, int32_t min, int32_t max);    \
+    extern void wrandi64v_##gen(struct wrandbs *bs, int64_t *out,           \
+                                size_t count, int64_t min, int64_t max);    \
+    extern void wrandu32v_##gen(struct wrandbs *bs, uint32_t *out,          \
+                                size_t count, uint32_t min, uint32_t max);  \
+    extern void wrandu64v_##gen(struct wrandbs *bs, uint64_t *out,          \
+                                size_t count, uint64_t min, uint64_t max);  \
+    extern void wrandf32v_##gen(struct wrandbs *bs, float *out,             \
+                                size_t count, double min, double max);      \
+    extern void wrandf64v_##gen(struct wrandbs *bs, double *out,            \
+                                size_t count, double min, double max);      \
+    extern void wgaussf32v_##gen(struct wrandbs *bs, float *out,            \
+                                 size_t count, double mean, double stddev); \
+    extern void wgaussf64v_##gen(struct wrandbs *bs, double *out,           \
+                                 size_t count, double mean, double stddev);
+
+WRANDBS_GEN_DECLARE(xoshiro256plus)
+WRANDBS_GEN_DECLARE(xoshiro256plusplus)
+WRANDBS_GEN_DECLARE(xoshiro256starstar)
+
+/* pools of streams for parallel use, all derived from one master seed.
+ * stream i starts where the master sequence would be after i jumps (2^64
+ * steps for randbs, 2^128 for wrandbs), so streams can't overlap unless
+ * one of them is used for that many values.  partition first long-jumps
+ * the master sequence that many times (2^96 or 2^192 steps each), so that
+ * e.g. separate processes can make disjoint pools from the same seed.
+ *
+ * the jumps are only valid for the xoshiro generators.  they are the same
+ * for all three scramblers of each size, so func must be one of
+ * xoshiro128{plus,plusplus,starstar}_next for a randbs_pool, or the
+ * xoshiro256 equivalents for a wrandbs_pool.
+ *
+ * each stream is aligned to and padded out to cache lines, so threads
+ * using different streams don't contend.  init returns 0 on success, or -1
+ * if memory allocation fails.
+ */
+struct randbs_pool {
+    struct randbs *streams;
+    size_t n_streams;
+    size_t n_claimed;
+    const void **owners;
+    void *alloc;
+};
+
+struct wrandbs_pool {
+    struct wrandbs *streams;
+    size_t n_streams;
+    size_t n_claimed;
+    const void **owners;
+    void *alloc;
+};
+
+extern int randbs_pool_init(struct randbs_pool *pool, size_t n_streams,
+                            uint32_t (*func)(struct state128 *),
+                            uint64_t seed, unsigned partition);
+extern void randbs_pool_fini(struct randbs_pool *pool);
+extern struct randbs *randbs_pool_get(struct randbs_pool *pool, size_t i);
+
+extern int wrandbs_pool_init(struct wrandbs_pool *pool, size_t n_streams,
+                             uint64_t (*func)(struct state256 *),
+                             uint64_t seed, unsigned partition);
+extern void wrandbs_pool_fini(struct wrandbs_pool *pool);
+extern struct wrandbs *wrandbs_pool_get(struct wrandbs_pool *pool, size_t i);
+
+/* the calling thread's own stream from the pool.  a thread's first call
+ * claims the next unclaimed stream, and later calls return the same one.
+ * which thread gets which stream depends on the order of their first
+ * calls, so if results need to be reproducible, give each worker
+ * *_pool_get(pool, worker_index) instead.  it's a fatal error for more
+ * threads than there are streams to claim one.
+ */
+extern struct randbs *randbs_pool_local(struct randbs_pool *pool);
+extern struct wrandbs *wrandbs_pool_local(struct wrandbs_pool *pool);
+
+/* checkpoints: a stream's position, as plain data that can be written out
+ * and restored in another process.  the generator and the algorithm
+ * choices are not included, as they are part of the stream's setup.
+ * the pool versions save or restore all n_streams streams at once.
+ */
+struct randbs_saved {
+    struct state128 state;
+    uint64_t bits;
+    uint32_t n_bits;
+    uint32_t has_gauss_spare;
+    double gauss_spare;
+};
+
+struct wrandbs_saved {
+    struct state256 state;
+    uint64_t bits;
+    uint32_t n_bits;
+    uint32_t has_gauss_spare;
+    double gauss_spare;
+};
+
+extern void randbs_save(const struct randbs *bs, struct randbs_saved *saved);
+extern void randbs_restore(struct randbs *bs,
+                           const struct randbs_saved *saved);
+extern void randbs_pool_save(const struct randbs_pool *pool,
+                             struct randbs_saved *saved);
+extern void randbs_pool_restore(struct randbs_pool *pool,
+                                const struct randbs_saved *saved);
+
+extern void wrandbs_save(const struct wrandbs *bs,
+                         struct wrandbs_saved *saved);
+extern void wrandbs_restore(struct wrandbs *bs,
+                            const struct wrandbs_saved *saved);
+extern void wrandbs_pool_save(const struct wrandbs_pool *pool,
+                              struct wrandbs_saved *saved);
+extern void wrandbs_pool_restore(struct wrandbs_pool *pool,
+                                 const struct wrandbs_saved *saved);
+
 inline bool wcoin(struct wrandbs *bs, float p_true)
 {
     return wrandf32(bs, 0.0, 1.0) <= p_true;
 }
 
+inline bool wcoin_fixed(struct wrandbs *bs, uint64_t threshold)
+{
+    return wrandbs_bits(bs, 32) < threshold;
+}
+
+extern void wbernoulli_mask(struct wrandbs *bs,
+                            uint64_t *mask,
+                            size_t n_bits,
+                            double p_true);
+
 #endif
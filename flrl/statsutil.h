@@ -104,6 +104,279 @@ extern void statsf64v(const double *values, size_t n_values,
                       double *pmax, size_t *pmax_frequency,
                       double *pmean, double *pvariance);
 
+/* the functions above, with the work shared between up to n_threads
+ * threads (0 for one per cpu, as for parallel_for() in flrl/parallel.h).
+ * results don't depend on the number of threads.  median, mode and the
+ * extremes are exact, as above.  mean and variance are summed in fixed
+ * blocks of values whose partial sums are merged in order, so on large
+ * inputs they can differ from the serial functions' in the last bits.
+ * mode breaks ties in favour of the least value.  median and mode need
+ * memory for two copies of large inputs of 32- or 64-bit values.
+ */
+extern double meani8v_parallel(const int8_t *values, size_t n_values,
+                               unsigned n_threads);
+extern double mediani8v_parallel(const int8_t *values, size_t n_values,
+                                 unsigned n_threads);
+extern int8_t modei8v_parallel(const int8_t *values, size_t n_values,
+                               size_t *pfrequency, unsigned n_threads);
+extern double variancei8v_parallel(const int8_t *values, size_t n_values,
+                                   double mean, unsigned n_threads);
+extern void statsi8v_parallel(const int8_t *values, size_t n_values,
+                              int8_t *pmin, size_t *pmin_frequency,
+                              int8_t *pmax, size_t *pmax_frequency,
+                              double *pmean, double *pvariance,
+                              unsigned n_threads);
+
+extern double meanu8v_parallel(const uint8_t *values, size_t n_values,
+                               unsigned n_threads);
+extern double medianu8v_parallel(const uint8_t *values, size_t n_values,
+                                 unsigned n_threads);
+extern uint8_t modeu8v_parallel(const uint8_t *values, size_t n_values,
+                                size_t *pfrequency, unsigned n_threads);
+extern double varianceu8v_parallel(const uint8_t *values, size_t n_values,
+                                   double mean, unsigned n_threads);
+extern void statsu8v_parallel(const uint8_t *values, size_t n_values,
+                              uint8_t *pmin, size_t *pmin_frequency,
+                              uint8_t *pmax, size_t *pmax_frequency,
+                              double *pmean, double *pvariance,
+                              unsigned n_threads);
+
+extern double meani16v_parallel(const int16_t *values, size_t n_values,
+                                unsigned n_threads);
+extern double mediani16v_parallel(const int16_t *values, size_t n_values,
+                                  unsigned n_threads);
+extern int16_t modei16v_parallel(const int16_t *values, size_t n_values,
+                                 size_t *pfrequency, unsigned n_threads);
+extern double variancei16v_parallel(const int16_t *values, size_t n_values,
+                                    double mean, unsigned n_threads);
+extern void statsi16v_parallel(const int16_t *values, size_t n_values,
+                               int16_t *pmin, size_t *pmin_frequency,
+                               int16_t *pmax, size_t *pmax_frequency,
+                               double *pmean, double *pvariance,
+                               unsigned n_threads);
+
+extern double meanu16v_parallel(const uint16_t *values, size_t n_values,
+                                unsigned n_threads);
+extern double medianu16v_parallel(const uint16_t *values, size_t n_values,
+                                  unsigned n_threads);
+extern uint16_t modeu16v_parallel(const uint16_t *values, size_t n_values,
+                                  size_t *pfrequency, unsigned n_threads);
+extern double varianceu16v_parallel(const uint16_t *values, size_t n_values,
+                                    double mean, unsigned n_threads);
+extern void statsu16v_parallel(const uint16_t *values, size_t n_values,
+                               uint16_t *pmin, size_t *pmin_frequency,
+                               uint16_t *pmax, size_t *pmax_frequency,
+                               double *pmean, double *pvariance,
+                               unsigned n_threads);
+
+extern double meani32v_parallel(const int32_t *values, size_t n_values,
+                                unsigned n_threads);
+extern double mediani32v_parallel(const int32_t *values, size_t n_values,
+                                  unsigned n_threads);
+extern int32_t modei32v_parallel(const int32_t *values, size_t n_values,
+                                 size_t *pfrequency, unsigned n_threads);
+extern double variancei32v_parallel(const int32_t *values, size_t n_values,
+                                    double mean, unsigned n_threads);
+extern void statsi32v_parallel(const int32_t *values, size_t n_values,
+                               int32_t *pmin, size_t *pmin_frequency,
+                               int32_t *pmax, size_t *pmax_frequency,
+                               double *pmean, double *pvariance,
+                               unsigned n_threads);
+
+extern double meanu32v_parallel(const uint32_t *values, size_t n_values,
+                                unsigned n_threads);
+extern double medianu32v_parallel(const uint32_t *values, size_t n_values,
+                                  unsigned n_threads);
+extern uint32_t modeu32v_parallel(const uint32_t *values, size_t n_values,
+                                  size_t *pfrequency, unsigned n_threads);
+extern double varianceu32v_parallel(const uint32_t *values, size_t n_values,
+                                    double mean, unsigned n_threads);
+extern void statsu32v_parallel(const uint32_t *values, size_t n_values,
+                               uint32_t *pmin, size_t *pmin_frequency,
+                               uint32_t *pmax, size_t *pmax_frequency,
+                               double *pmean, double *pvariance,
+                               unsigned n_threads);
+
+extern double meani64v_parallel(const int64_t *values, size_t n_values,
+                                unsigned n_threads);
+extern double mediani64v_parallel(const int64_t *values, size_t n_values,
+                                  unsigned n_threads);
+extern int64_t modei64v_parallel(const int64_t *values, size_t n_values,
+                                 size_t *pfrequency, unsigned n_threads);
+extern double variancei64v_parallel(const int64_t *values, size_t n_values,
+                                    double mean, unsigned n_threads);
+extern void statsi64v_parallel(const int64_t *values, size_t n_values,
+                               int64_t *pmin, size_t *pmin_frequency,
+                               int64_t *pmax, size_t *pmax_frequency,
+                               double *pmean, double *pvariance,
+                               unsigned n_threads);
+
+extern double meanu64v_parallel(const uint64_t *values, size_t n_values,
+                                unsigned n_threads);
+extern double medianu64v_parallel(const uint64_t *values, size_t n_values,
+                                  unsigned n_threads);
+extern uint64_t modeu64v_parallel(const uint64_t *values, size_t n_values,
+                                  size_t *pfrequency, unsigned n_threads);
+extern double varianceu64v_parallel(const uint64_t *values, size_t n_values,
+                                    double mean, unsigned n_threads);
+extern void statsu64v_parallel(const uint64_t *values, size_t n_values,
+                               uint64_t *pmin, size_t *pmin_frequency,
+                               uint64_t *pmax, size_t *pmax_frequency,
+                               double *pmean, double *pvariance,
+                               unsigned n_threads);
+
+extern double meanf32v_parallel(const float *values, size_t n_values,
+                                unsigned n_threads);
+extern double medianf32v_parallel(const float *values, size_t n_values,
+                                  unsigned n_threads);
+extern double variancef32v_parallel(const float *values, size_t n_values,
+                                    double mean, unsigned n_threads);
+extern void statsf32v_parallel(const float *values, size_t n_values,
+                               float *pmin, size_t *pmin_frequency,
+                               float *pmax, size_t *pmax_frequency,
+                               double *pmean, double *pvariance,
+                               unsigned n_threads);
+
+extern double meanf64v_parallel(const double *values, size_t n_values,
+                                unsigned n_threads);
+extern double medianf64v_parallel(const double *values, size_t n_values,
+                                  unsigned n_threads);
+extern double variancef64v_parallel(const double *values, size_t n_values,
+                                    double mean, unsigned n_threads);
+extern void statsf64v_parallel(const double *values, size_t n_values,
+                               double *pmin, size_t *pmin_frequency,
+                               double *pmax, size_t *pmax_frequency,
+                               double *pmean, double *pvariance,
+                               unsigned n_threads);
+
+/* running stats over a stream of values, for when they can't all be kept
+ * in memory.  push adds one value, pushv adds an array of them (using the
+ * same block kernel as stats*v), and merge folds another accumulator of the
+ * same type into this one, e.g. partial results from several threads.
+ * mean and m2 (the sum of squared deviations) are combined as in Chan et
+ * al's parallel variance, with compensated sums.
+ *
+ * result gives the same outputs as stats*v would over every value pushed
+ * so far; mean and variance are nan while there are too few values.  an
+ * accumulator must only be used with one type's functions.  initialise it
+ * with STATS_ACC_INITIALIZER, or zero it.
+ */
+union stats_acc_value {
+    int64_t i;
+    uint64_t u;
+    double f;
+};
+
+struct stats_acc {
+    size_t n_values;
+    union stats_acc_value min, max;
+    size_t min_frequency, max_frequency;
+    double mean, mean_c;
+    double m2, m2_c;
+};
+
+#define STATS_ACC_INITIALIZER { 0 }
+
+extern void stats_acc_pushi8(struct stats_acc *acc, int8_t value);
+extern void stats_acc_pushi8v(struct stats_acc *acc,
+                              const int8_t *values, size_t n_values);
+extern void stats_acc_mergei8(struct stats_acc *acc,
+                              const struct stats_acc *other);
+extern void stats_acc_resulti8(const struct stats_acc *acc,
+                               int8_t *pmin, size_t *pmin_frequency,
+                               int8_t *pmax, size_t *pmax_frequency,
+                               double *pmean, double *pvariance);
+
+extern void stats_acc_pushu8(struct stats_acc *acc, uint8_t value);
+extern void stats_acc_pushu8v(struct stats_acc *acc,
+                              const uint8_t *values, size_t n_values);
+extern void stats_acc_mergeu8(struct stats_acc *acc,
+                              const struct stats_acc *other);
+extern void stats_acc_resultu8(const struct stats_acc *acc,
+                               uint8_t *pmin, size_t *pmin_frequency,
+                               uint8_t *pmax, size_t *pmax_frequency,
+                               double *pmean, double *pvariance);
+
+extern void stats_acc_pushi16(struct stats_acc *acc, int16_t value);
+extern void stats_acc_pushi16v(struct stats_acc *acc,
+                               const int16_t *values, size_t n_values);
+extern void stats_acc_mergei16(struct stats_acc *acc,
+                               const struct stats_acc *other);
+extern void stats_acc_resulti16(const struct stats_acc *acc,
+                                int16_t *pmin, size_t *pmin_frequency,
+                                int16_t *pmax, size_t *pmax_frequency,
+                                double *pmean, double *pvariance);
+
+extern void stats_acc_pushu16(struct stats_acc *acc, uint16_t value);
+extern void stats_acc_pushu16v(struct stats_acc *acc,
+                               const uint16_t *values, size_t n_values);
+extern void stats_acc_mergeu16(struct stats_acc *acc,
+                               const struct stats_acc *other);
+extern void stats_acc_resultu16(const struct stats_acc *acc,
+                                uint16_t *pmin, size_t *pmin_frequency,
+                                uint16_t *pmax, size_t *pmax_frequency,
+                                double *pmean, double *pvariance);
+
+extern void stats_acc_pushi32(struct stats_acc *acc, int32_t value);
+extern void stats_acc_pushi32v(struct stats_acc *acc,
+                               const int32_t *values, size_t n_values);
+extern void stats_acc_mergei32(struct stats_acc *acc,
+                               const struct stats_acc *other);
+extern void stats_acc_resulti32(const struct stats_acc *acc,
+                                int32_t *pmin, size_t *pmin_frequency,
+                                int32_t *pmax, size_t *pmax_frequency,
+                                double *pmean, double *pvariance);
+
+extern void stats_acc_pushu32(struct stats_acc *acc, uint32_t value);
+extern void stats_acc_pushu32v(struct stats_acc *acc,
+                               const uint32_t *values, size_t n_values);
+extern void stats_acc_mergeu32(struct stats_acc *acc,
+                               const struct stats_acc *other);
+extern void stats_acc_resultu32(const struct stats_acc *acc,
+                                uint32_t *pmin, size_t *pmin_frequency,
+                                uint32_t *pmax, size_t *pmax_frequency,
+                                double *pmean, double *pvariance);
+
+extern void stats_acc_pushi64(struct stats_acc *acc, int64_t value);
+extern void stats_acc_pushi64v(struct stats_acc *acc,
+                               const int64_t *values, size_t n_values);
+extern void stats_acc_mergei64(struct stats_acc *acc,
+                               const struct stats_acc *other);
+extern void stats_acc_resulti64(const struct stats_acc *acc,
+                                int64_t *pmin, size_t *pmin_frequency,
+                                int64_t *pmax, size_t *pmax_frequency,
+                                double *pmean, double *pvariance);
+
+extern void stats_acc_pushu64(struct stats_acc *acc, uint64_t value);
+extern void stats_acc_pushu64v(struct stats_acc *acc,
+                               const uint64_t *values, size_t n_values);
+extern void stats_acc_mergeu64(struct stats_acc *acc,
+                               const struct stats_acc *other);
+extern void stats_acc_resultu64(const struct stats_acc *acc,
+                                uint64_t *pmin, size_t *pmin_frequency,
+                                uint64_t *pmax, size_t *pmax_frequency,
+                                double *pmean, double *pvariance);
+
+extern void stats_acc_pushf32(struct stats_acc *acc, float value);
+extern void stats_acc_pushf32v(struct stats_acc *acc,
+                               const float *values, size_t n_values);
+extern void stats_acc_mergef32(struct stats_acc *acc,
+                               const struct stats_acc *other);
+extern void stats_acc_resultf32(const struct stats_acc *acc,
+                                float *pmin, size_t *pmin_frequency,
+                                float *pmax, size_t *pmax_frequency,
+                                double *pmean, double *pvariance);
+
+extern void stats_acc_pushf64(struct stats_acc *acc, double value);
+extern void stats_acc_pushf64v(struct stats_acc *acc,
+                               const double *values, size_t n_values);
+extern void stats_acc_mergef64(struct stats_acc *acc,
+                               const struct stats_acc *other);
+extern void stats_acc_resultf64(const struct stats_acc *acc,
+                                double *pmin, size_t *pmin_frequency,
+                                double *pmax, size_t *pmax_frequency,
+                                double *pmean, double *pvariance);
+
 enum summary7_fence {
     FENCE_IQR15,
     FENCE_OCTILE,
@@ -163,6 +436,235 @@ extern int summary7f64v(Summary7 *summary7,
                         const double *values, size_t n_values,
                         enum summary7_fence fence);
 
+/* summary7 with the work shared between threads, as for the _parallel
+ * functions above.  the results are the same as summary7's.
+ */
+extern int summary7i8v_parallel(Summary7 *summary7,
+                                const int8_t *values, size_t n_values,
+                                enum summary7_fence fence,
+                                unsigned n_threads);
+extern int summary7u8v_parallel(Summary7 *summary7,
+                                const uint8_t *values, size_t n_values,
+                                enum summary7_fence fence,
+                                unsigned n_threads);
+extern int summary7i16v_parallel(Summary7 *summary7,
+                                 const int16_t *values, size_t n_values,
+                                 enum summary7_fence fence,
+                                 unsigned n_threads);
+extern int summary7u16v_parallel(Summary7 *summary7,
+                                 const uint16_t *values, size_t n_values,
+                                 enum summary7_fence fence,
+                                 unsigned n_threads);
+extern int summary7i32v_parallel(Summary7 *summary7,
+                                 const int32_t *values, size_t n_values,
+                                 enum summary7_fence fence,
+                                 unsigned n_threads);
+extern int summary7u32v_parallel(Summary7 *summary7,
+                                 const uint32_t *values, size_t n_values,
+                                 enum summary7_fence fence,
+                                 unsigned n_threads);
+extern int summary7i64v_parallel(Summary7 *summary7,
+                                 const int64_t *values, size_t n_values,
+                                 enum summary7_fence fence,
+                                 unsigned n_threads);
+extern int summary7u64v_parallel(Summary7 *summary7,
+                                 const uint64_t *values, size_t n_values,
+                                 enum summary7_fence fence,
+                                 unsigned n_threads);
+extern int summary7f32v_parallel(Summary7 *summary7,
+                                 const float *values, size_t n_values,
+                                 enum summary7_fence fence,
+                                 unsigned n_threads);
+extern int summary7f64v_parallel(Summary7 *summary7,
+                                 const double *values, size_t n_values,
+                                 enum summary7_fence fence,
+                                 unsigned n_threads);
+
+/* as above, but rearranging the caller's values rather than a copy of them,
+ * so there's no allocation.  on return the values are permuted, with any
+ * nans moved to the end.  both use selection rather than sorting, so they
+ * take expected linear time, with the same results as sorting would give.
+ */
+extern double mediani8v_inplace(int8_t *values, size_t n_values);
+extern double medianu8v_inplace(uint8_t *values, size_t n_values);
+extern double mediani16v_inplace(int16_t *values, size_t n_values);
+extern double medianu16v_inplace(uint16_t *values, size_t n_values);
+extern double mediani32v_inplace(int32_t *values, size_t n_values);
+extern double medianu32v_inplace(uint32_t *values, size_t n_values);
+extern double mediani64v_inplace(int64_t *values, size_t n_values);
+extern double medianu64v_inplace(uint64_t *values, size_t n_values);
+extern double medianf32v_inplace(float *values, size_t n_values);
+extern double medianf64v_inplace(double *values, size_t n_values);
+
+extern void summary7i8v_inplace(Summary7 *summary7,
+                                int8_t *values, size_t n_values,
+                                enum summary7_fence fence);
+extern void summary7u8v_inplace(Summary7 *summary7,
+                                uint8_t *values, size_t n_values,
+                                enum summary7_fence fence);
+extern void summary7i16v_inplace(Summary7 *summary7,
+                                 int16_t *values, size_t n_values,
+                                 enum summary7_fence fence);
+extern void summary7u16v_inplace(Summary7 *summary7,
+                                 uint16_t *values, size_t n_values,
+                                 enum summary7_fence fence);
+extern void summary7i32v_inplace(Summary7 *summary7,
+                                 int32_t *values, size_t n_values,
+                                 enum summary7_fence fence);
+extern void summary7u32v_inplace(Summary7 *summary7,
+                                 uint32_t *values, size_t n_values,
+                                 enum summary7_fence fence);
+extern void summary7i64v_inplace(Summary7 *summary7,
+                                 int64_t *values, size_t n_values,
+                                 enum summary7_fence fence);
+extern void summary7u64v_inplace(Summary7 *summary7,
+                                 uint64_t *values, size_t n_values,
+                                 enum summary7_fence fence);
+extern void summary7f32v_inplace(Summary7 *summary7,
+                                 float *values, size_t n_values,
+                                 enum summary7_fence fence);
+extern void summary7f64v_inplace(Summary7 *summary7,
+                                 double *values, size_t n_values,
+                                 enum summary7_fence fence);
+
+/* stores to out[i] the ps[i]-quantile of values, for n_ps values of p in
+ * [0, 1], in any order.  quantiles use the same method as summary7's,
+ * nans in values are ignored, and a nan p gives a nan quantile.  all of ps
+ * are answered by one selection pass, in expected linear time for a
+ * handful of quantiles.  the _inplace versions permute values rather than
+ * copying them.  returns 0 on success, or -1 if memory couldn't be
+ * allocated.
+ *
+ * the copying versions of quantiles and summary7 radix sort their copy of
+ * large enough 32-bit inputs instead, which is quicker than selecting
+ * several positions.  either way the results are the same.
+ */
+extern int quantilesi8v(double *out,
+                        const int8_t *values, size_t n_values,
+                        const double *ps, size_t n_ps);
+extern int quantilesu8v(double *out,
+                        const uint8_t *values, size_t n_values,
+                        const double *ps, size_t n_ps);
+extern int quantilesi16v(double *out,
+                         const int16_t *values, size_t n_values,
+                         const double *ps, size_t n_ps);
+extern int quantilesu16v(double *out,
+                         const uint16_t *values, size_t n_values,
+                         const double *ps, size_t n_ps);
+extern int quantilesi32v(double *out,
+                         const int32_t *values, size_t n_values,
+                         const double *ps, size_t n_ps);
+extern int quantilesu32v(double *out,
+                         const uint32_t *values, size_t n_values,
+                         const double *ps, size_t n_ps);
+extern int quantilesi64v(double *out,
+                         const int64_t *values, size_t n_values,
+                         const double *ps, size_t n_ps);
+extern int quantilesu64v(double *out,
+                         const uint64_t *values, size_t n_values,
+                         const double *ps, size_t n_ps);
+extern int quantilesf32v(double *out,
+                         const float *values, size_t n_values,
+                         const double *ps, size_t n_ps);
+extern int quantilesf64v(double *out,
+                         const double *values, size_t n_values,
+                         const double *ps, size_t n_ps);
+
+extern int quantilesi8v_inplace(double *out,
+                                int8_t *values, size_t n_values,
+                                const double *ps, size_t n_ps);
+extern int quantilesu8v_inplace(double *out,
+                                uint8_t *values, size_t n_values,
+                                const double *ps, size_t n_ps);
+extern int quantilesi16v_inplace(double *out,
+                                 int16_t *values, size_t n_values,
+                                 const double *ps, size_t n_ps);
+extern int quantilesu16v_inplace(double *out,
+                                 uint16_t *values, size_t n_values,
+                                 const double *ps, size_t n_ps);
+extern int quantilesi32v_inplace(double *out,
+                                 int32_t *values, size_t n_values,
+                                 const double *ps, size_t n_ps);
+extern int quantilesu32v_inplace(double *out,
+                                 uint32_t *values, size_t n_values,
+                                 const double *ps, size_t n_ps);
+extern int quantilesi64v_inplace(double *out,
+                                 int64_t *values, size_t n_values,
+                                 const double *ps, size_t n_ps);
+extern int quantilesu64v_inplace(double *out,
+                                 uint64_t *values, size_t n_values,
+                                 const double *ps, size_t n_ps);
+extern int quantilesf32v_inplace(double *out,
+                                 float *values, size_t n_values,
+                                 const double *ps, size_t n_ps);
+extern int quantilesf64v_inplace(double *out,
+                                 double *values, size_t n_values,
+                                 const double *ps, size_t n_ps);
+
+/* streaming quantile sketch, for summarising more values than can be kept.
+ * values are counted in logarithmic buckets (as in Masson et al's
+ * DDSketch), so every quantile is within a relative error of alpha of a
+ * value that would be at that rank, in memory that grows only with the
+ * range of magnitudes seen.  min and max are exact.  zero has a bucket of
+ * its own, and nans are ignored.
+ *
+ * qsketch_init() sets up an empty sketch with the given alpha, in
+ * [QSKETCH_MIN_ALPHA, 1).  each sign keeps at most max_buckets buckets
+ * (0 for QSKETCH_DEFAULT_MAX_BUCKETS); beyond that, the buckets nearest
+ * zero are collapsed together, losing accuracy there first.  a sketch
+ * spans about max_buckets * 2 * alpha / ln(10) decades before that, so the
+ * default covers 18 decades at an alpha of 0.01.  sketches with the same
+ * alpha can be merged, e.g. from several threads or shards.
+ *
+ * qsketch_quantiles() and qsketch_summary7() answer as quantiles*v() and
+ * summary7*v() would over the bucketed values, so e.g. a struct boxplot
+ * can be filled from a sketch, with qs->n_values as n_samples.
+ *
+ * qsketch_serialize() writes the sketch to buf if buf_size is big enough,
+ * and returns the size it needs either way.  the format is in host byte
+ * order.  qsketch_deserialize() initialises qs from such a buffer.
+ *
+ * functions returning int return 0 on success, or -1 if alpha is out of
+ * range, memory couldn't be allocated, the sketches' alphas differ, or the
+ * buffer isn't a serialized sketch.
+ */
+struct qsketch_store {
+    size_t *counts;
+    size_t n_buckets;
+    int32_t offset;
+};
+
+struct qsketch {
+    double alpha;
+    double ln_gamma;
+    size_t max_buckets;
+    size_t n_values;
+    size_t n_zero;
+    double min, max;
+    struct qsketch_store neg, pos;
+};
+
+#define QSKETCH_MIN_ALPHA (1e-6)
+#define QSKETCH_DEFAULT_MAX_BUCKETS (2048U)
+
+extern int qsketch_init(struct qsketch *qs, double alpha, size_t max_buckets);
+extern void qsketch_fini(struct qsketch *qs);
+
+extern int qsketch_insert(struct qsketch *qs, double value);
+extern int qsketch_insertv(struct qsketch *qs,
+                           const double *values, size_t n_values);
+extern int qsketch_merge(struct qsketch *qs, const struct qsketch *other);
+
+extern void qsketch_quantiles(double *out, const struct qsketch *qs,
+                              const double *ps, size_t n_ps);
+extern void qsketch_summary7(Summary7 *summary7, const struct qsketch *qs,
+                             enum summary7_fence fence);
+
+extern size_t qsketch_serialize(const struct qsketch *qs,
+                                void *buf, size_t buf_size);
+extern int qsketch_deserialize(struct qsketch *qs,
+                               const void *buf, size_t buf_size);
+
 struct hist_bucket {
     size_t freq_raw;
     double freq_pc;
@@ -210,10 +712,154 @@ extern void histogram_freqf64v(Histogram *hist, const char *title,
                                const double *values, size_t n_values,
                                const double *thresholds, size_t n_thresholds);
 
+/* histogram_freq*v(), with values counted across up to n_threads threads
+ * (0 for one per cpu, as for parallel_for() in flrl/parallel.h).  the
+ * result is the same whatever the number of threads.
+ */
+extern void histogram_freqi8v_parallel(Histogram *hist, const char *title,
+                                       const int8_t *values, size_t n_values,
+                                       const int8_t *thresholds,
+                                       size_t n_thresholds,
+                                       unsigned n_threads);
+extern void histogram_frequ8v_parallel(Histogram *hist, const char *title,
+                                       const uint8_t *values, size_t n_values,
+                                       const uint8_t *thresholds,
+                                       size_t n_thresholds,
+                                       unsigned n_threads);
+extern void histogram_freqi16v_parallel(Histogram *hist, const char *title,
+                                        const int16_t *values, size_t n_values,
+                                        const int16_t *thresholds,
+                                        size_t n_thresholds,
+                                        unsigned n_threads);
+extern void histogram_frequ16v_parallel(Histogram *hist, const char *title,
+                                        const uint16_t *values, size_t n_values,
+                                        const uint16_t *thresholds,
+                                        size_t n_thresholds,
+                                        unsigned n_threads);
+extern void histogram_freqi32v_parallel(Histogram *hist, const char *title,
+                                        const int32_t *values, size_t n_values,
+                                        const int32_t *thresholds,
+                                        size_t n_thresholds,
+                                        unsigned n_threads);
+extern void histogram_frequ32v_parallel(Histogram *hist, const char *title,
+                                        const uint32_t *values, size_t n_values,
+                                        const uint32_t *thresholds,
+                                        size_t n_thresholds,
+                                        unsigned n_threads);
+extern void histogram_freqi64v_parallel(Histogram *hist, const char *title,
+                                        const int64_t *values, size_t n_values,
+                                        const int64_t *thresholds,
+                                        size_t n_thresholds,
+                                        unsigned n_threads);
+extern void histogram_frequ64v_parallel(Histogram *hist, const char *title,
+                                        const uint64_t *values, size_t n_values,
+                                        const uint64_t *thresholds,
+                                        size_t n_thresholds,
+                                        unsigned n_threads);
+extern void histogram_freqf32v_parallel(Histogram *hist, const char *title,
+                                        const float *values, size_t n_values,
+                                        const float *thresholds,
+                                        size_t n_thresholds,
+                                        unsigned n_threads);
+extern void histogram_freqf64v_parallel(Histogram *hist, const char *title,
+                                        const double *values, size_t n_values,
+                                        const double *thresholds,
+                                        size_t n_thresholds,
+                                        unsigned n_threads);
+
 extern void histogram_print(const Histogram *hist, FILE *out);
 
 extern void histogram_fini(Histogram *hist);
 
+/* log-linear histogram of unsigned integer values, such as latencies in
+ * ticks, after Gil Tene's HdrHistogram.  values below 2^sub_bits are
+ * counted exactly; above that, each power of two is split into 2^sub_bits
+ * buckets, so every value is known to within a relative 2^-sub_bits.
+ * recording is O(1), a bit scan, a shift and an add, and min and max are
+ * exact.
+ *
+ * hdrhist_record() is for a histogram only one thread records into, such
+ * as one of a set of per-thread histograms that are merged afterwards.
+ * hdrhist_record_atomic() can be used by any number of threads at once on
+ * a shared histogram, without locks; anything else must wait until
+ * they're done.
+ *
+ * hdrhist_quantiles() and hdrhist_summary7() answer as quantiles*v() and
+ * summary7*v() would over the midpoints of the values' buckets.
+ * hdrhist_histogram() counts the same midpoints into a Histogram for
+ * histogram_print(), with thresholds as for histogram_frequ64v().
+ *
+ * functions returning int return 0 on success, or -1 if sub_bits is out of
+ * range, memory couldn't be allocated, or the histograms' sub_bits differ.
+ */
+#define HDRHIST_DEFAULT_SUB_BITS (7U)
+#define HDRHIST_MAX_SUB_BITS (16U)
+
+struct hdrhist {
+    unsigned sub_bits;
+    size_t n_counts;
+    uint64_t *counts;
+    uint64_t n_values;
+    uint64_t min, max;
+};
+
+extern int hdrhist_init(struct hdrhist *h, unsigned sub_bits);
+extern void hdrhist_fini(struct hdrhist *h);
+extern void hdrhist_reset(struct hdrhist *h);
+
+/* index of value's bucket in h->counts */
+inline size_t hdrhist_index(const struct hdrhist *h, uint64_t value)
+{
+    const unsigned msb = 63 - __builtin_clzll(value | 1);
+    const unsigned shift = (msb > h->sub_bits ? msb : h->sub_bits)
+                           - h->sub_bits;
+
+    return ((size_t) shift << h->sub_bits) + (size_t) (value >> shift);
+}
+
+inline void hdrhist_record(struct hdrhist *h, uint64_t value)
+{
+    h->counts[hdrhist_index(h, value)] ++;
+    h->n_values ++;
+    if (value < h->min) h->min = value;
+    if (value > h->max) h->max = value;
+}
+
+inline void hdrhist_record_atomic(struct hdrhist *h, uint64_t value)
+{
+    uint64_t seen;
+
+    __atomic_fetch_add(&h->counts[hdrhist_index(h, value)], 1,
+                       __ATOMIC_RELAXED);
+    __atomic_fetch_add(&h->n_values, 1, __ATOMIC_RELAXED);
+
+    seen = __atomic_load_n(&h->min, __ATOMIC_RELAXED);
+    while (value < seen
+           && !__atomic_compare_exchange_n(&h->min, &seen, value, true,
+                                           __ATOMIC_RELAXED,
+                                           __ATOMIC_RELAXED))
+        ;
+
+    seen = __atomic_load_n(&h->max, __ATOMIC_RELAXED);
+    while (value > seen
+           && !__atomic_compare_exchange_n(&h->max, &seen, value, true,
+                                           __ATOMIC_RELAXED,
+                                           __ATOMIC_RELAXED))
+        ;
+}
+
+extern int hdrhist_merge(struct hdrhist *h, const struct hdrhist *other);
+
+extern double hdrhist_percentile(const struct hdrhist *h, double p);
+extern void hdrhist_quantiles(double *out, const struct hdrhist *h,
+                              const double *ps, size_t n_ps);
+extern void hdrhist_summary7(Summary7 *summary7, const struct hdrhist *h,
+                             enum summary7_fence fence);
+extern void hdrhist_histogram(Histogram *hist, const char *title,
+                              const struct hdrhist *h,
+                              const uint64_t *thresholds,
+                              size_t n_thresholds);
+
 struct boxplot {
     const char *label;
     size_t n_samples;
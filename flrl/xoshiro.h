@@ -6,6 +6,14 @@
 
 #include <stdint.h>
 
+static inline uint32_t xoshiro_rotl32(const uint32_t x, int k) {
+    return (x << k) | (x >> (32 - k));
+}
+
+static inline uint64_t xoshiro_rotl64(const uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
 /* This is xoshiro128+ 1.0, our best and fastest 32-bit generator for 32-bit
    floating-point numbers. We suggest to use its upper bits for
    floating-point generation, as it is slightly faster than xoshiro128**.
@@ -19,9 +27,28 @@
 
    The state must be seeded so that it is not everywhere zero. */
 extern uint32_t xoshiro128plus_next(struct state128 *state);
+
 extern void xoshiro128plus_jump(struct state128 *state);
 extern void xoshiro128plus_long_jump(struct state128 *state);
 
+/* inlinable body of xoshiro128plus_next() */
+static inline uint32_t xoshiro128plus_next_inline(struct state128 *state) {
+    const uint32_t result = state->s[0] + state->s[3];
+
+    const uint32_t t = state->s[1] << 9;
+
+    state->s[2] ^= state->s[0];
+    state->s[3] ^= state->s[1];
+    state->s[1] ^= state->s[2];
+    state->s[0] ^= state->s[3];
+
+    state->s[2] ^= t;
+
+    state->s[3] = xoshiro_rotl32(state->s[3], 11);
+
+    return result;
+}
+
 
 /* This is xoshiro128++ 1.0, one of our 32-bit all-purpose, rock-solid
    generators. It has excellent speed, a state size (128 bits) that is
@@ -33,9 +60,28 @@ extern void xoshiro128plus_long_jump(struct state128 *state);
 
    The state must be seeded so that it is not everywhere zero. */
 extern uint32_t xoshiro128plusplus_next(struct state128 *state);
+
 extern void xoshiro128plusplus_jump(struct state128 *state);
 extern void xoshiro128plusplus_long_jump(struct state128 *state);
 
+/* inlinable body of xoshiro128plusplus_next() */
+static inline uint32_t xoshiro128plusplus_next_inline(struct state128 *state) {
+    const uint32_t result = xoshiro_rotl32(state->s[0] + state->s[3], 7) + state->s[0];
+
+    const uint32_t t = state->s[1] << 9;
+
+    state->s[2] ^= state->s[0];
+    state->s[3] ^= state->s[1];
+    state->s[1] ^= state->s[2];
+    state->s[0] ^= state->s[3];
+
+    state->s[2] ^= t;
+
+    state->s[3] = xoshiro_rotl32(state->s[3], 11);
+
+    return result;
+}
+
 
 /* This is xoshiro128** 1.1, one of our 32-bit all-purpose, rock-solid
    generators. It has excellent speed, a state size (128 bits) that is
@@ -50,9 +96,28 @@ extern void xoshiro128plusplus_long_jump(struct state128 *state);
 
    The state must be seeded so that it is not everywhere zero. */
 extern uint32_t xoshiro128starstar_next(struct state128 *state);
+
 extern void xoshiro128starstar_jump(struct state128 *state);
 extern void xoshiro128starstar_long_jump(struct state128 *state);
 
+/* inlinable body of xoshiro128starstar_next() */
+static inline uint32_t xoshiro128starstar_next_inline(struct state128 *state) {
+    const uint32_t result = xoshiro_rotl32(state->s[1] * 5, 7) * 9;
+
+    const uint32_t t = state->s[1] << 9;
+
+    state->s[2] ^= state->s[0];
+    state->s[3] ^= state->s[1];
+    state->s[1] ^= state->s[2];
+    state->s[0] ^= state->s[3];
+
+    state->s[2] ^= t;
+
+    state->s[3] = xoshiro_rotl32(state->s[3], 11);
+
+    return result;
+}
+
 
 /* This is xoshiro256+ 1.0, our best and fastest generator for floating-point
    numbers. We suggest to use its upper bits for floating-point
@@ -69,9 +134,28 @@ extern void xoshiro128starstar_long_jump(struct state128 *state);
    a 64-bit seed, we suggest to seed a splitmix64 generator and use its
    output to fill s. */
 extern uint64_t xoshiro256plus_next(struct state256 *state);
+
 extern void xoshiro256plus_jump(struct state256 *state);
 extern void xoshiro256plus_long_jump(struct state256 *state);
 
+/* inlinable body of xoshiro256plus_next() */
+static inline uint64_t xoshiro256plus_next_inline(struct state256 *state) {
+    const uint64_t result = state->s[0] + state->s[3];
+
+    const uint64_t t = state->s[1] << 17;
+
+    state->s[2] ^= state->s[0];
+    state->s[3] ^= state->s[1];
+    state->s[1] ^= state->s[2];
+    state->s[0] ^= state->s[3];
+
+    state->s[2] ^= t;
+
+    state->s[3] = xoshiro_rotl64(state->s[3], 45);
+
+    return result;
+}
+
 
 /* This is xoshiro256++ 1.0, one of our all-purpose, rock-solid generators.
    It has excellent (sub-ns) speed, a state (256 bits) that is large
@@ -84,9 +168,28 @@ extern void xoshiro256plus_long_jump(struct state256 *state);
    a 64-bit seed, we suggest to seed a splitmix64 generator and use its
    output to fill s. */
 extern uint64_t xoshiro256plusplus_next(struct state256 *state);
+
 extern void xoshiro256plusplus_jump(struct state256 *state);
 extern void xoshiro256plusplus_long_jump(struct state256 *state);
 
+/* inlinable body of xoshiro256plusplus_next() */
+static inline uint64_t xoshiro256plusplus_next_inline(struct state256 *state) {
+    const uint64_t result = xoshiro_rotl64(state->s[0] + state->s[3], 23) + state->s[0];
+
+    const uint64_t t = state->s[1] << 17;
+
+    state->s[2] ^= state->s[0];
+    state->s[3] ^= state->s[1];
+    state->s[1] ^= state->s[2];
+    state->s[0] ^= state->s[3];
+
+    state->s[2] ^= t;
+
+    state->s[3] = xoshiro_rotl64(state->s[3], 45);
+
+    return result;
+}
+
 
 /* This is xoshiro256** 1.0, one of our all-purpose, rock-solid
    generators. It has excellent (sub-ns) speed, a state (256 bits) that is
@@ -99,7 +202,26 @@ extern void xoshiro256plusplus_long_jump(struct state256 *state);
    a 64-bit seed, we suggest to seed a splitmix64 generator and use its
    output to fill s. */
 extern uint64_t xoshiro256starstar_next(struct state256 *state);
+
 extern void xoshiro256starstar_jump(struct state256 *state);
 extern void xoshiro256starstar_long_jump(struct state256 *state);
 
+/* inlinable body of xoshiro256starstar_next() */
+static inline uint64_t xoshiro256starstar_next_inline(struct state256 *state) {
+    const uint64_t result = xoshiro_rotl64(state->s[1] * 5, 7) * 9;
+
+    const uint64_t t = state->s[1] << 17;
+
+    state->s[2] ^= state->s[0];
+    state->s[3] ^= state->s[1];
+    state->s[1] ^= state->s[2];
+    state->s[0] ^= state->s[3];
+
+    state->s[2] ^= t;
+
+    state->s[3] = xoshiro_rotl64(state->s[3], 45);
+
+    return result;
+}
+
 #endif
@@ -56,6 +56,26 @@ static void keygen_u32_seq(struct randbs *rbs __attribute__((unused)),
     next_key ++;
 }
 
+/* ranks from a Zipf distribution over all of u32, so a few keys are very
+ * common and most are rare.  drawn in batches, since each zipfu32v() call
+ * has some setup cost
+ */
+static double zipf_exponent = 0.99;
+
+static void keygen_u32_zipf(struct randbs *rbs, void **pkey, size_t *plen)
+{
+    static uint32_t keys[4096];
+    static unsigned next_key = sizeof(keys) / sizeof(keys[0]);
+
+    if (next_key == sizeof(keys) / sizeof(keys[0])) {
+        zipfu32v(rbs, keys, next_key, UINT32_MAX, zipf_exponent);
+        next_key = 0;
+    }
+
+    *pkey = &keys[next_key++];
+    *plen = sizeof(keys[0]);
+}
+
 static void keygen_vp16_rand(struct randbs *rbs, void **pkey, size_t *plen)
 {
     static char word[16];
@@ -72,6 +92,7 @@ enum keygen_id {
     KEYGEN_U32_RAND = 0,
     KEYGEN_U32_SEQ,
     KEYGEN_VP16_RAND,
+    KEYGEN_U32_ZIPF,
 
     N_KEYGENS,
 };
@@ -84,6 +105,7 @@ static const struct keygen {
     { "u32r", sizeof(uint32_t), &keygen_u32_rand },
     { "u32s", sizeof(uint32_t), &keygen_u32_seq },
     { "vp16r", 16, &keygen_vp16_rand },
+    { "u32z", sizeof(uint32_t), &keygen_u32_zipf },
 };
 static_assert(N_KEYGENS == sizeof(keygens) / sizeof(keygens[0]));
 static const struct keygen *keygen = &keygens[KEYGEN_U32_RAND];
@@ -451,6 +473,7 @@ int main(int argc, char **argv)
         { "grow",                 no_argument,       NULL, 'g' },
         { "load-factor",          required_argument, NULL, 'l' },
         { "shrink",               no_argument,       NULL, 's' },
+        { "zipf-exponent",        required_argument, NULL, 'Z' },
         { NULL,                   0,                 NULL,  0  },
     };
     struct randbs rbs = RANDBS_INITIALIZER(&xoshiro128plusplus_next);
@@ -496,6 +519,11 @@ int main(int argc, char **argv)
         case 's':
             want_shrink = true;
             break;
+        case 'Z':
+            zipf_exponent = atof(optarg);
+            if (!(zipf_exponent >= 0.0))
+                r = usage();
+            break;
         default:
             r = usage();
             break;
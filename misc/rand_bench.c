@@ -0,0 +1,289 @@
+#include "flrl/randutil.h"
+#include "flrl/xoshiro.h"
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#define N_MAX (1U << 20)
+
+static union {
+    uint32_t u32[N_MAX];
+    uint64_t u64[N_MAX];
+    float f32[N_MAX];
+    double f64[N_MAX];
+} out;
+
+/* bs is a struct randbs or a struct wrandbs, depending on the function */
+typedef void (bench_fn)(void *bs, size_t count);
+
+static int usage(void)
+{
+    fputs("Usage: rand_bench [-n count] [-r repeats]\n", stderr);
+    return 64; /* EX_USAGE */
+}
+
+static double now(void)
+{
+    struct timespec ts;
+
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+
+static void u32_full_dyn(void *bs, size_t count)
+{
+    randu32v(bs, out.u32, count, 0, UINT32_MAX);
+}
+
+static void u32_full_gen(void *bs, size_t count)
+{
+    randu32v_xoshiro128plusplus(bs, out.u32, count, 0, UINT32_MAX);
+}
+
+static void u32_1000_dyn(void *bs, size_t count)
+{
+    randu32v(bs, out.u32, count, 0, 999);
+}
+
+static void u32_1000_gen(void *bs, size_t count)
+{
+    randu32v_xoshiro128plusplus(bs, out.u32, count, 0, 999);
+}
+
+static void u32_1000_lemire_dyn(void *bs, size_t count)
+{
+    struct randbs *rbs = bs;
+
+    rbs->int_method = RANDBS_INT_LEMIRE;
+    randu32v(rbs, out.u32, count, 0, 999);
+    rbs->int_method = RANDBS_INT_MASK;
+}
+
+static void u32_1000_lemire_gen(void *bs, size_t count)
+{
+    struct randbs *rbs = bs;
+
+    rbs->int_method = RANDBS_INT_LEMIRE;
+    randu32v_xoshiro128plusplus(rbs, out.u32, count, 0, 999);
+    rbs->int_method = RANDBS_INT_MASK;
+}
+
+static void u64_full_dyn(void *bs, size_t count)
+{
+    randu64v(bs, out.u64, count, 0, UINT64_MAX);
+}
+
+static void u64_full_gen(void *bs, size_t count)
+{
+    randu64v_xoshiro128plusplus(bs, out.u64, count, 0, UINT64_MAX);
+}
+
+static void f32_dyn(void *bs, size_t count)
+{
+    randf32v(bs, out.f32, count, 0.0, 1.0);
+}
+
+static void f32_gen(void *bs, size_t count)
+{
+    randf32v_xoshiro128plusplus(bs, out.f32, count, 0.0, 1.0);
+}
+
+static void f64_dyn(void *bs, size_t count)
+{
+    randf64v(bs, out.f64, count, 0.0, 1.0);
+}
+
+static void f64_gen(void *bs, size_t count)
+{
+    randf64v_xoshiro128plusplus(bs, out.f64, count, 0.0, 1.0);
+}
+
+static void gauss64_dyn(void *bs, size_t count)
+{
+    gaussf64v(bs, out.f64, count, 0.0, 1.0);
+}
+
+static void gauss64_gen(void *bs, size_t count)
+{
+    gaussf64v_xoshiro128plusplus(bs, out.f64, count, 0.0, 1.0);
+}
+
+static void gauss64_zig_dyn(void *bs, size_t count)
+{
+    struct randbs *rbs = bs;
+
+    rbs->gauss_method = RANDBS_GAUSS_ZIGGURAT;
+    gaussf64v(rbs, out.f64, count, 0.0, 1.0);
+    rbs->gauss_method = RANDBS_GAUSS_POLAR;
+}
+
+static void gauss64_zig_gen(void *bs, size_t count)
+{
+    struct randbs *rbs = bs;
+
+    rbs->gauss_method = RANDBS_GAUSS_ZIGGURAT;
+    gaussf64v_xoshiro128plusplus(rbs, out.f64, count, 0.0, 1.0);
+    rbs->gauss_method = RANDBS_GAUSS_POLAR;
+}
+
+static const struct bench {
+    const char *name;
+    bench_fn *dyn;
+    bench_fn *gen;
+} benches[] = {
+    { "randu32v [0, UINT32_MAX]", &u32_full_dyn, &u32_full_gen },
+    { "randu32v [0, 999]", &u32_1000_dyn, &u32_1000_gen },
+    { "randu32v [0, 999] lemire", &u32_1000_lemire_dyn, &u32_1000_lemire_gen },
+    { "randu64v [0, UINT64_MAX]", &u64_full_dyn, &u64_full_gen },
+    { "randf32v [0, 1]", &f32_dyn, &f32_gen },
+    { "randf64v [0, 1]", &f64_dyn, &f64_gen },
+    { "gaussf64v (0, 1)", &gauss64_dyn, &gauss64_gen },
+    { "gaussf64v (0, 1) ziggurat", &gauss64_zig_dyn, &gauss64_zig_gen },
+};
+static const size_t n_benches = sizeof(benches) / sizeof(benches[0]);
+
+static void w_u32_1000_dyn(void *bs, size_t count)
+{
+    wrandu32v(bs, out.u32, count, 0, 999);
+}
+
+static void w_u32_1000_gen(void *bs, size_t count)
+{
+    wrandu32v_xoshiro256plusplus(bs, out.u32, count, 0, 999);
+}
+
+static void w_u64_full_dyn(void *bs, size_t count)
+{
+    wrandu64v(bs, out.u64, count, 0, UINT64_MAX);
+}
+
+static void w_u64_full_gen(void *bs, size_t count)
+{
+    wrandu64v_xoshiro256plusplus(bs, out.u64, count, 0, UINT64_MAX);
+}
+
+static void w_f64_dyn(void *bs, size_t count)
+{
+    wrandf64v(bs, out.f64, count, 0.0, 1.0);
+}
+
+static void w_f64_gen(void *bs, size_t count)
+{
+    wrandf64v_xoshiro256plusplus(bs, out.f64, count, 0.0, 1.0);
+}
+
+static void w_gauss64_dyn(void *bs, size_t count)
+{
+    wgaussf64v(bs, out.f64, count, 0.0, 1.0);
+}
+
+static void w_gauss64_gen(void *bs, size_t count)
+{
+    wgaussf64v_xoshiro256plusplus(bs, out.f64, count, 0.0, 1.0);
+}
+
+/* the same workloads on a 32-bit randbs and a 64-bit wrandbs stream */
+static const struct wbench {
+    const char *name;
+    bench_fn *narrow;
+    bench_fn *dyn;
+    bench_fn *gen;
+} wbenches[] = {
+    { "[w]randu32v [0, 999]",
+      &u32_1000_gen, &w_u32_1000_dyn, &w_u32_1000_gen },
+    { "[w]randu64v [0, UINT64_MAX]",
+      &u64_full_gen, &w_u64_full_dyn, &w_u64_full_gen },
+    { "[w]randf64v [0, 1]",
+      &f64_gen, &w_f64_dyn, &w_f64_gen },
+    { "[w]gaussf64v (0, 1)",
+      &gauss64_gen, &w_gauss64_dyn, &w_gauss64_gen },
+};
+static const size_t n_wbenches = sizeof(wbenches) / sizeof(wbenches[0]);
+
+/* returns best-of-repeats nanoseconds per value */
+static double run(bench_fn *fn, void *bs,
+                  size_t n_values, size_t per_call, unsigned repeats)
+{
+    double best = -1.0;
+    unsigned r;
+
+    for (r = 0; r < repeats; r++) {
+        double start, elapsed;
+        size_t i;
+
+        start = now();
+        for (i = 0; i < n_values; i += per_call)
+            fn(bs, per_call);
+        elapsed = now() - start;
+
+        if (best < 0.0 || elapsed < best)
+            best = elapsed;
+    }
+
+    return 1e9 * best / n_values;
+}
+
+int main(int argc, char **argv)
+{
+    struct randbs bs = RANDBS_INITIALIZER(xoshiro128plusplus_next);
+    struct wrandbs wbs = WRANDBS_INITIALIZER(xoshiro256plusplus_next);
+    size_t n_values = N_MAX;
+    unsigned repeats = 5;
+    unsigned i;
+    int opt;
+
+    while (-1 != (opt = getopt(argc, argv, "n:r:"))) {
+        switch (opt) {
+        case 'n':
+            n_values = strtoul(optarg, NULL, 0);
+            break;
+        case 'r':
+            repeats = strtoul(optarg, NULL, 0);
+            break;
+        default:
+            return usage();
+        }
+    }
+
+    if (!n_values || n_values > N_MAX || !repeats)
+        return usage();
+
+    randbs_seed64(&bs, time(NULL));
+    wrandbs_seed64(&wbs, time(NULL));
+
+    printf("%zu values, best of %u, ns per value\n", n_values, repeats);
+    printf("%-26s %10s %10s %10s %10s\n", "",
+           "bulk", "bulk", "per-call", "per-call");
+    printf("%-26s %10s %10s %10s %10s\n", "",
+           "func ptr", "inlined", "func ptr", "inlined");
+
+    for (i = 0; i < n_benches; i++) {
+        const struct bench *b = &benches[i];
+
+        printf("%-26s %10.3f %10.3f %10.3f %10.3f\n", b->name,
+               run(b->dyn, &bs, n_values, n_values, repeats),
+               run(b->gen, &bs, n_values, n_values, repeats),
+               run(b->dyn, &bs, n_values, 1, repeats),
+               run(b->gen, &bs, n_values, 1, repeats));
+    }
+
+    printf("\n%-28s %10s %10s %10s\n", "",
+           "randbs", "wrandbs", "wrandbs");
+    printf("%-28s %10s %10s %10s\n", "",
+           "inlined", "func ptr", "inlined");
+
+    for (i = 0; i < n_wbenches; i++) {
+        const struct wbench *b = &wbenches[i];
+
+        printf("%-28s %10.3f %10.3f %10.3f\n", b->name,
+               run(b->narrow, &bs, n_values, n_values, repeats),
+               run(b->dyn, &wbs, n_values, n_values, repeats),
+               run(b->gen, &wbs, n_values, n_values, repeats));
+    }
+
+    return 0;
+}
@@ -8,6 +8,7 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include <unistd.h>
 
@@ -70,18 +71,170 @@ void count_distinct_converted64(void)
     printf("64 bit rng naively converts to %" PRIu64 " possible doubles\n", count);
 }
 
+static const struct float_mode {
+    const char *name;
+    enum randbs_float_method method;
+} float_modes[] = {
+    { "precise", RANDBS_FLOAT_PRECISE },
+    { "fast", RANDBS_FLOAT_FAST },
+};
+static const size_t n_float_modes = sizeof(float_modes)
+                                    / sizeof(float_modes[0]);
+
+static double now(void)
+{
+    struct timespec ts;
+
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+
+/* distinct floats randf32v() can return for [low, high] in each mode, by
+ * converting every value the mode can make in [0, 1] the way randfv does.
+ * conversion is monotonic, so only changes need counting
+ */
+void count_reachable32(float low, float high)
+{
+    const double range = (double) high - low;
+    uint64_t count;
+    uint32_t i;
+    float curr, prev;
+
+    /* precise: every float in [0, 1] */
+    count = 0;
+    prev = nanf("");
+    for (i = 0; i <= 0x3f800000; i++) {
+        float v;
+
+        memcpy(&v, &i, sizeof(v));
+        curr = fma(range, v, low);
+        if (curr != prev) {
+            count ++;
+            prev = curr;
+        }
+    }
+
+    printf("[%#.*g, %#.*g] precise mode reaches %" PRIu64 " floats\n",
+           FLT_DECIMAL_DIG, low,
+           FLT_DECIMAL_DIG, high,
+           count);
+
+    /* fast: k / 2^24 for k in [0, 2^24) */
+    count = 0;
+    prev = nanf("");
+    for (i = 0; i < UINT32_C(1) << 24; i++) {
+        curr = low + range * (i * 0x1p-24);
+        if (curr != prev) {
+            count ++;
+            prev = curr;
+        }
+    }
+
+    printf("[%#.*g, %#.*g) fast mode reaches %" PRIu64 " floats\n",
+           FLT_DECIMAL_DIG, low,
+           FLT_DECIMAL_DIG, high,
+           count);
+}
+
+/* too many to enumerate, so just [0, 1]: precise reaches every double in
+ * it, i.e. the bit patterns from 0.0 up to 1.0, and fast reaches 2^53
+ */
+void count_reachable64(void)
+{
+    const double one = 1.0;
+    uint64_t one_bits;
+
+    memcpy(&one_bits, &one, sizeof(one_bits));
+
+    printf("[0, 1] precise mode reaches %" PRIu64 " doubles\n",
+           one_bits + 1);
+    printf("[0, 1) fast mode reaches %" PRIu64 " doubles\n",
+           UINT64_C(1) << 53);
+}
+
+/* best-of-repeats ns per value of randf32v and randf64v in each mode, both
+ * through the stream's func pointer and with the generator inlined
+ */
+void bench_modes(double low, double high)
+{
+    const size_t n_values = 1 << 20;
+    const unsigned repeats = 5;
+    struct randbs bs = RANDBS_INITIALIZER(xoshiro128plusplus_next);
+    double *f64;
+    float *f32;
+    size_t m;
+
+    randbs_seed64(&bs, time(NULL));
+
+    f32 = calloc(n_values, sizeof(f32[0]));
+    f64 = calloc(n_values, sizeof(f64[0]));
+    if (!f32 || !f64) abort();
+
+    printf("%-10s %10s %10s %10s %10s\n", "",
+           "randf32v", "randf32v", "randf64v", "randf64v");
+    printf("%-10s %10s %10s %10s %10s\n", "ns/value",
+           "func ptr", "inlined", "func ptr", "inlined");
+
+    for (m = 0; m < n_float_modes; m++) {
+        double best[4] = { INFINITY, INFINITY, INFINITY, INFINITY };
+        double start;
+        unsigned r;
+
+        bs.float_method = float_modes[m].method;
+
+        for (r = 0; r < repeats; r++) {
+            start = now();
+            randf32v(&bs, f32, n_values, low, high);
+            best[0] = fmin(best[0], now() - start);
+
+            start = now();
+            randf32v_xoshiro128plusplus(&bs, f32, n_values, low, high);
+            best[1] = fmin(best[1], now() - start);
+
+            start = now();
+            randf64v(&bs, f64, n_values, low, high);
+            best[2] = fmin(best[2], now() - start);
+
+            start = now();
+            randf64v_xoshiro128plusplus(&bs, f64, n_values, low, high);
+            best[3] = fmin(best[3], now() - start);
+        }
+
+        printf("%-10s %10.3f %10.3f %10.3f %10.3f\n", float_modes[m].name,
+               1e9 * best[0] / n_values,
+               1e9 * best[1] / n_values,
+               1e9 * best[2] / n_values,
+               1e9 * best[3] / n_values);
+    }
+
+    free(f64);
+    free(f32);
+}
+
 int main(int argc, char **argv)
 {
     int opt;
+    bool do_bench = false;
     bool do_counts = false;
+    bool do_modes = false;
     bool do_randutil = false;
+    bool fast = false;
     double low = 0.0, high = 1.0;
 
-    while (-1 != (opt = getopt(argc, argv, "cdh:l:r"))) {
+    while (-1 != (opt = getopt(argc, argv, "bcdfh:l:mr"))) {
         switch (opt) {
+        case 'b':
+            do_bench = true;
+            break;
         case 'c':
             do_counts = true;
             break;
+        case 'f':
+            fast = true;
+            break;
+        case 'm':
+            do_modes = true;
+            break;
         case 'h':
             high = atof(optarg);
             break;
@@ -104,6 +257,14 @@ int main(int argc, char **argv)
 //         count_distinct_converted64();
     }
 
+    if (do_modes) {
+        count_reachable32(low, high);
+        count_reachable64();
+    }
+
+    if (do_bench)
+        bench_modes(low, high);
+
 
     if (do_randutil) {
         struct randbs bs = RANDBS_INITIALIZER(xoshiro128plusplus_next);
@@ -112,6 +273,8 @@ int main(int argc, char **argv)
         unsigned i;
 
         randbs_seed64(&bs, time(NULL));
+        if (fast)
+            bs.float_method = RANDBS_FLOAT_FAST;
 
         values = calloc(n_values, sizeof(values[0]));
         if (!values) abort();
@@ -2,6 +2,7 @@
 
 #include <float.h>
 #include <math.h>
+#include <string.h>
 
 bool floats_equalish(double a, double b, double epsilon, double abs_th)
 {
@@ -31,12 +32,33 @@ void noinline_kbn_sumf64_r(double *sum, double *comp, double addend)
     KBN_SUMF64_R(sum, comp, addend);
 }
 
+extern inline void two_sumf64_r(double *sum, double *comp, double addend);
+
+typedef fputil_f64x2 f64x2;
+#define N_VECS FPUTIL_KBN_SUM_VECS
+
+extern inline void two_sumf64x2_r(f64x2 *sum, f64x2 *comp, f64x2 addend);
+extern inline void kbn_sumf64x2_r(double *sum, double *comp,
+                                  const f64x2 *sums, const f64x2 *comps,
+                                  size_t n_vecs);
+
 double kbn_sumf32v(const float *values, size_t n_values)
 {
+    f64x2 sums[N_VECS] = { 0 }, comps[N_VECS] = { 0 };
     double sum = 0.0, c = 0.0;
-    size_t i;
+    size_t i, v;
+
+    for (i = 0; i + 2 * N_VECS <= n_values; i += 2 * N_VECS) {
+        for (v = 0; v < N_VECS; v++) {
+            const f64x2 x = { values[i + 2 * v], values[i + 2 * v + 1] };
+
+            two_sumf64x2_r(&sums[v], &comps[v], x);
+        }
+    }
 
-    for (i = 0; i < n_values; i++)
+    kbn_sumf64x2_r(&sum, &c, sums, comps, N_VECS);
+
+    for (; i < n_values; i++)
         kbn_sumf64_r(&sum, &c, values[i]);
 
     return sum + c;
@@ -44,10 +66,22 @@ double kbn_sumf32v(const float *values, size_t n_values)
 
 double kbn_sumf64v(const double *values, size_t n_values)
 {
+    f64x2 sums[N_VECS] = { 0 }, comps[N_VECS] = { 0 };
     double sum = 0.0, c = 0.0;
-    size_t i;
+    size_t i, v;
+
+    for (i = 0; i + 2 * N_VECS <= n_values; i += 2 * N_VECS) {
+        for (v = 0; v < N_VECS; v++) {
+            f64x2 x;
+
+            memcpy(&x, &values[i + 2 * v], sizeof(x));
+            two_sumf64x2_r(&sums[v], &comps[v], x);
+        }
+    }
+
+    kbn_sumf64x2_r(&sum, &c, sums, comps, N_VECS);
 
-    for (i = 0; i < n_values; i++)
+    for (; i < n_values; i++)
         kbn_sumf64_r(&sum, &c, values[i]);
 
     return sum + c;
@@ -0,0 +1,109 @@
+#include "flrl/parallel.h"
+
+#include "flrl/xassert.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <sysinfoapi.h>
+#else
+#include <unistd.h>
+#endif
+
+#define MIN(a,b) ({         \
+    __auto_type _a = (a);   \
+    __auto_type _b = (b);   \
+    _a < _b ? _a : _b;      \
+})
+
+struct parallel_task {
+    parallel_fn *fn;
+    void *arg;
+    unsigned chunk;
+    size_t begin;
+    size_t end;
+    pthread_t thread;
+    int started;
+};
+
+unsigned parallel_ncpu(void)
+{
+    static unsigned ncpu = 0;
+    unsigned n;
+
+    n = __atomic_load_n(&ncpu, __ATOMIC_RELAXED);
+    if (n) return n;
+
+#ifdef _WIN32
+    SYSTEM_INFO si;
+
+    GetSystemInfo(&si);
+    n = si.dwNumberOfProcessors;
+#else
+    long r = sysconf(_SC_NPROCESSORS_ONLN);
+
+    n = r > 0 ? (unsigned) r : 1;
+#endif
+
+    n = n ? n : 1;
+    __atomic_store_n(&ncpu, n, __ATOMIC_RELAXED);
+    return n;
+}
+
+unsigned parallel_chunks(unsigned n_threads, size_t n_items, size_t min_chunk)
+{
+    size_t max_chunks;
+
+    if (!n_threads)
+        n_threads = parallel_ncpu();
+    if (!min_chunk)
+        min_chunk = 1;
+
+    max_chunks = n_items / min_chunk;
+    return max_chunks ? MIN(n_threads, max_chunks) : 1;
+}
+
+static void *parallel_run(void *p)
+{
+    struct parallel_task *task = p;
+
+    task->fn(task->arg, task->chunk, task->begin, task->end);
+    return NULL;
+}
+
+void parallel_for(unsigned n_threads,
+                  size_t n_items,
+                  size_t min_chunk,
+                  parallel_fn *fn,
+                  void *arg)
+{
+    const unsigned n_chunks = parallel_chunks(n_threads, n_items, min_chunk);
+    struct parallel_task tasks[n_chunks];
+    unsigned c;
+
+    hard_assert(fn != NULL);
+
+    for (c = 0; c < n_chunks; c++) {
+        struct parallel_task *t = &tasks[c];
+
+        t->fn = fn;
+        t->arg = arg;
+        t->chunk = c;
+        t->begin = n_items / n_chunks * c + MIN(c, n_items % n_chunks);
+        t->end = t->begin + n_items / n_chunks + (c < n_items % n_chunks);
+        t->started = c > 0
+                     && 0 == pthread_create(&t->thread, NULL,
+                                            &parallel_run, t);
+    }
+
+    for (c = 0; c < n_chunks; c++) {
+        if (!tasks[c].started)
+            parallel_run(&tasks[c]);
+    }
+
+    for (c = 1; c < n_chunks; c++) {
+        if (tasks[c].started)
+            pthread_join(tasks[c].thread, NULL);
+    }
+}
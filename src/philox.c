@@ -0,0 +1,6 @@
+#include "flrl/philox.h"
+
+uint32_t philox4x32_next(struct state128 *state)
+{
+    return philox4x32_next_inline(state);
+}
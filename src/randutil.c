@@ -2,6 +2,7 @@
 
 #include "flrl/splitmix64.h"
 #include "flrl/xassert.h"
+#include "flrl/xoshiro.h"
 
 #include <math.h>
 #include <stdarg.h>
@@ -19,11 +20,26 @@
     _a < _b ? _a : _b;      \
 })
 
+void *randutil_malloc(size_t size)
+{
+    return malloc(size);
+}
+
+void randutil_free(void *ptr)
+{
+    free(ptr);
+}
+
 double randutil_fma(double x, double y, double z)
 {
     return fma(x, y, z);
 }
 
+double randutil_exp(double x)
+{
+    return exp(x);
+}
+
 double randutil_log(double x)
 {
     return log(x);
@@ -34,6 +50,16 @@ double randutil_sqrt(double x)
     return sqrt(x);
 }
 
+double randutil_log1p(double x)
+{
+    return log1p(x);
+}
+
+double randutil_expm1(double x)
+{
+    return expm1(x);
+}
+
 void state_seed(void *state, size_t state_len,
                 const void *seed, size_t seed_len)
 {
@@ -56,26 +82,488 @@ void state_seed_sm64(void *state, size_t state_len, uint64_t seed)
     memcpy(state, buf, state_len);
 }
 
-void shuffle(struct randbs *rbs, void *base, size_t n_elems, size_t elem_size)
+static void randx8_seed_lanes(struct randx8 *bs, struct state128 *lane)
 {
-    unsigned char *array = base, *tmp;
-    size_t i, j;
+    unsigned i, l;
 
-    tmp = malloc(elem_size);
+    for (l = 0; l < RANDX8_LANES; l++) {
+        if (l) xoshiro128plusplus_jump(lane);
 
-    /* if malloc failed, order is unchanged, but that's a valid outcome */
-    if (MALLOC_FAILED(!tmp)) return;
+        for (i = 0; i < 4; i++)
+            bs->s[i][l] = lane->s[i];
+    }
 
-    for (i = 0; i < n_elems - 1; i++) {
-        j = randu64(rbs, i, n_elems - 1);
-        if (i != j) {
-            memcpy(tmp, array + i * elem_size, elem_size);
-            memcpy(array + i * elem_size, array + j * elem_size, elem_size);
-            memcpy(array + j * elem_size, tmp, elem_size);
-        }
+    bs->n_buf = 0;
+}
+
+void randx8_seed(struct randx8 *bs, const struct state128 *seed)
+{
+    struct state128 lane;
+
+    state128_seed(&lane, seed);
+    randx8_seed_lanes(bs, &lane);
+}
+
+void randx8_seed64(struct randx8 *bs, uint64_t seed)
+{
+    struct state128 lane;
+
+    state128_seed64(&lane, seed);
+    randx8_seed_lanes(bs, &lane);
+}
+
+/* a vector of lanes, sized to the widest integer vectors the target has:
+ * one vector covers all the lanes with AVX2, it takes two with SSE2/NEON.
+ * wider generic vectors than the hardware has get spilled to the stack */
+#if defined(__AVX2__)
+# define RANDX8_VEC_LANES (8U)
+#else
+# define RANDX8_VEC_LANES (4U)
+#endif
+#define RANDX8_N_VECS (RANDX8_LANES / RANDX8_VEC_LANES)
+typedef uint32_t randx8_vec __attribute__((vector_size(4 * RANDX8_VEC_LANES)));
+
+#define ROTL32V(x, k) (((x) << (k)) | ((x) >> (32 - (k))))
+
+/* one xoshiro128++ step on every lane at once, storing the lanes' outputs
+ * to out */
+static inline void randx8_next(randx8_vec s[4][RANDX8_N_VECS], uint32_t *out)
+{
+    unsigned v;
+
+    for (v = 0; v < RANDX8_N_VECS; v++) {
+        const randx8_vec t = s[1][v] << 9;
+        const randx8_vec r = ROTL32V(s[0][v] + s[3][v], 7) + s[0][v];
+
+        memcpy(out + v * RANDX8_VEC_LANES, &r, sizeof(r));
+
+        s[2][v] ^= s[0][v];
+        s[3][v] ^= s[1][v];
+        s[1][v] ^= s[2][v];
+        s[0][v] ^= s[3][v];
+        s[2][v] ^= t;
+        s[3][v] = ROTL32V(s[3][v], 11);
+    }
+}
+
+void randx8_u32v(struct randx8 *bs, uint32_t *out, size_t count)
+{
+    randx8_vec s[4][RANDX8_N_VECS];
+    size_t i, n;
+
+    static_assert(sizeof(s) == sizeof(bs->s));
+
+    /* use up leftovers from the last partial block first */
+    n = MIN(count, (size_t) bs->n_buf);
+    memcpy(out, bs->buf + RANDX8_LANES - bs->n_buf, n * sizeof(out[0]));
+    bs->n_buf -= n;
+
+    if (n == count) return;
+
+    /* work on a local copy so the compiler can keep it in registers */
+    memcpy(s, bs->s, sizeof(s));
+
+    for (i = n; i + RANDX8_LANES <= count; i += RANDX8_LANES)
+        randx8_next(s, out + i);
+
+    if (i < count) {
+        n = count - i;
+
+        randx8_next(s, bs->buf);
+        memcpy(out + i, bs->buf, n * sizeof(out[0]));
+        bs->n_buf = RANDX8_LANES - n;
+    }
+
+    memcpy(bs->s, s, sizeof(s));
+}
+
+void randx8_u64v(struct randx8 *bs, uint64_t *out, size_t count)
+{
+    uint32_t words[16 * RANDX8_LANES];
+    size_t i;
+
+    while (count) {
+        const size_t n = MIN(count, sizeof(words) / sizeof(words[0]) / 2);
+
+        randx8_u32v(bs, words, 2 * n);
+
+        for (i = 0; i < n; i++)
+            out[i] = (uint64_t) words[2 * i + 1] << 32 | words[2 * i];
+
+        out += n;
+        count -= n;
+    }
+}
+
+/* xoshiro256++ on four interleaved lanes, laid out like randx8, for
+ * wrandbs_fill().  lane 0 starts at state, and each following lane is a
+ * jump further on.  state is left at the last lane's start
+ */
+#define WRANDX4_LANES (4U)
+typedef uint64_t wrandx4_vec __attribute__((vector_size(8 * WRANDX4_LANES)));
+
+#define ROTL64V(x, k) (((x) << (k)) | ((x) >> (64 - (k))))
+
+static inline void wrandx4_next(wrandx4_vec s[4], uint64_t *out)
+{
+    const wrandx4_vec t = s[1] << 17;
+    const wrandx4_vec r = ROTL64V(s[0] + s[3], 23) + s[0];
+
+    memcpy(out, &r, sizeof(r));
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = ROTL64V(s[3], 45);
+}
+
+static void wrandx4_fill(struct state256 *state, uint64_t *out, size_t count)
+{
+    wrandx4_vec s[4];
+    uint64_t tail[WRANDX4_LANES];
+    size_t i, l;
+
+    for (l = 0; l < WRANDX4_LANES; l++) {
+        if (l) xoshiro256plusplus_jump(state);
+
+        for (i = 0; i < 4; i++)
+            s[i][l] = state->s[i];
+    }
+
+    for (i = 0; i + WRANDX4_LANES <= count; i += WRANDX4_LANES)
+        wrandx4_next(s, out + i);
+
+    if (i < count) {
+        wrandx4_next(s, tail);
+        memcpy(out + i, tail, (count - i) * sizeof(out[0]));
+    }
+}
+
+void randbs_fill(struct randbs *bs, void *buf, size_t len)
+{
+    uint8_t *p = buf;
+    uint32_t w;
+
+    /* whole bytes left in the bit buffer go first, then single bytes up to
+     * word alignment, so that the bulk can be stored a word at a time
+     */
+    while (len && bs->n_bits >= 8) {
+        *p++ = randbs_bits(bs, 8);
+        len--;
+    }
+    while (len && (uintptr_t) p % sizeof(w)) {
+        *p++ = randbs_bits(bs, 8);
+        len--;
+    }
+
+    /* the lanes are seeded from the stream's output rather than its own
+     * jumps, which are the streams that follow it in a pool */
+    if (len >= RANDBS_FILL_LANES_MIN && bs->func == &xoshiro128plusplus_next) {
+        const size_t n = len / sizeof(w);
+        struct randx8 x8;
+        uint64_t seed;
+
+        seed = bs->func(&bs->state);
+        seed |= (uint64_t) bs->func(&bs->state) << 32;
+
+        randx8_seed64(&x8, seed);
+        randx8_u32v(&x8, (uint32_t *) p, n);
+
+        p += n * sizeof(w);
+        len -= n * sizeof(w);
+    }
+
+    for (; len >= sizeof(w); len -= sizeof(w)) {
+        w = bs->func(&bs->state);
+        memcpy(p, &w, sizeof(w));
+        p += sizeof(w);
+    }
+
+    /* and the last few through the bit buffer, which keeps the rest */
+    while (len--)
+        *p++ = randbs_bits(bs, 8);
+}
+
+void wrandbs_fill(struct wrandbs *bs, void *buf, size_t len)
+{
+    uint8_t *p = buf;
+    uint64_t w;
+
+    while (len && bs->n_bits >= 8) {
+        *p++ = wrandbs_bits(bs, 8);
+        len--;
+    }
+    while (len && (uintptr_t) p % sizeof(w)) {
+        *p++ = wrandbs_bits(bs, 8);
+        len--;
+    }
+
+    if (len >= RANDBS_FILL_LANES_MIN
+        && bs->func == &xoshiro256plusplus_next) {
+        const size_t n = len / sizeof(w);
+        struct state256 lane;
+
+        state256_seed64(&lane, bs->func(&bs->state));
+        wrandx4_fill(&lane, (uint64_t *) p, n);
+
+        p += n * sizeof(w);
+        len -= n * sizeof(w);
+    }
+
+    for (; len >= sizeof(w); len -= sizeof(w)) {
+        w = bs->func(&bs->state);
+        memcpy(p, &w, sizeof(w));
+        p += sizeof(w);
+    }
+
+    while (len--)
+        *p++ = wrandbs_bits(bs, 8);
+}
+
+/* randbs_pool and wrandbs_pool only differ in the type of their streams,
+ * so the bookkeeping is shared, with streams handled as stream_size blobs
+ */
+#define POOL_ALIGN (64U)
+
+static int pool_alloc(void **alloc, void **streams, const void ***owners,
+                      size_t n_streams, size_t stream_size)
+{
+    hard_assert(n_streams > 0);
+
+    *alloc = malloc(n_streams * stream_size + POOL_ALIGN - 1);
+    *owners = calloc(n_streams, sizeof(**owners));
+
+    if (MALLOC_FAILED(!*alloc || !*owners)) {
+        free(*owners);
+        free(*alloc);
+        *alloc = NULL;
+        *owners = NULL;
+        return -1;
+    }
+
+    *streams = (void *) (((uintptr_t) *alloc + POOL_ALIGN - 1)
+                         & ~(uintptr_t) (POOL_ALIGN - 1));
+    return 0;
+}
+
+/* only its address matters: it's unique to each running thread */
+static _Thread_local char pool_thread_token;
+
+static _Thread_local struct {
+    const void **owners;
+    size_t i;
+} pool_local_cache;
+
+static size_t pool_local_index(const void **owners, size_t n_streams,
+                               size_t *n_claimed)
+{
+    const void *const me = &pool_thread_token;
+    size_t i, n;
+
+    /* fast path: same pool as last time */
+    i = pool_local_cache.i;
+    if (pool_local_cache.owners == owners && i < n_streams
+        && __atomic_load_n(&owners[i], __ATOMIC_ACQUIRE) == me)
+        return i;
+
+    /* did this thread already claim one? */
+    n = MIN(__atomic_load_n(n_claimed, __ATOMIC_ACQUIRE), n_streams);
+    for (i = 0; i < n; i++) {
+        if (__atomic_load_n(&owners[i], __ATOMIC_ACQUIRE) == me)
+            goto found;
+    }
+
+    i = __atomic_fetch_add(n_claimed, 1, __ATOMIC_ACQ_REL);
+    hard_assert(i < n_streams);
+    __atomic_store_n(&owners[i], me, __ATOMIC_RELEASE);
+
+found:
+    pool_local_cache.owners = owners;
+    pool_local_cache.i = i;
+    return i;
+}
+
+int randbs_pool_init(struct randbs_pool *pool, size_t n_streams,
+                     uint32_t (*func)(struct state128 *),
+                     uint64_t seed, unsigned partition)
+{
+    struct state128 master;
+    void *streams;
+    size_t i;
+
+    /* the jumps that separate the streams only hold for xoshiro128 */
+    hard_assert(func == &xoshiro128plus_next
+                || func == &xoshiro128plusplus_next
+                || func == &xoshiro128starstar_next);
+
+    memset(pool, 0, sizeof(*pool));
+    if (pool_alloc(&pool->alloc, &streams, &pool->owners,
+                   n_streams, sizeof(pool->streams[0])))
+        return -1;
+
+    pool->streams = streams;
+    pool->n_streams = n_streams;
+    pool->n_claimed = 0;
+
+    state128_seed64(&master, seed);
+    while (partition--)
+        xoshiro128plusplus_long_jump(&master);
+
+    for (i = 0; i < n_streams; i++) {
+        if (i) xoshiro128plusplus_jump(&master);
+
+        pool->streams[i] = RANDBS_INITIALIZER(func);
+        randbs_seed(&pool->streams[i], &master);
+    }
+
+    return 0;
+}
+
+void randbs_pool_fini(struct randbs_pool *pool)
+{
+    free(pool->owners);
+    free(pool->alloc);
+    memset(pool, 0, sizeof(*pool));
+}
+
+struct randbs *randbs_pool_get(struct randbs_pool *pool, size_t i)
+{
+    hard_assert(i < pool->n_streams);
+    return &pool->streams[i];
+}
+
+struct randbs *randbs_pool_local(struct randbs_pool *pool)
+{
+    return &pool->streams[pool_local_index(pool->owners, pool->n_streams,
+                                           &pool->n_claimed)];
+}
+
+int wrandbs_pool_init(struct wrandbs_pool *pool, size_t n_streams,
+                      uint64_t (*func)(struct state256 *),
+                      uint64_t seed, unsigned partition)
+{
+    struct state256 master;
+    void *streams;
+    size_t i;
+
+    hard_assert(func == &xoshiro256plus_next
+                || func == &xoshiro256plusplus_next
+                || func == &xoshiro256starstar_next);
+
+    memset(pool, 0, sizeof(*pool));
+    if (pool_alloc(&pool->alloc, &streams, &pool->owners,
+                   n_streams, sizeof(pool->streams[0])))
+        return -1;
+
+    pool->streams = streams;
+    pool->n_streams = n_streams;
+    pool->n_claimed = 0;
+
+    state256_seed64(&master, seed);
+    while (partition--)
+        xoshiro256plusplus_long_jump(&master);
+
+    for (i = 0; i < n_streams; i++) {
+        if (i) xoshiro256plusplus_jump(&master);
+
+        pool->streams[i] = WRANDBS_INITIALIZER(func);
+        wrandbs_seed(&pool->streams[i], &master);
     }
 
-    free(tmp);
+    return 0;
+}
+
+void wrandbs_pool_fini(struct wrandbs_pool *pool)
+{
+    free(pool->owners);
+    free(pool->alloc);
+    memset(pool, 0, sizeof(*pool));
+}
+
+struct wrandbs *wrandbs_pool_get(struct wrandbs_pool *pool, size_t i)
+{
+    hard_assert(i < pool->n_streams);
+    return &pool->streams[i];
+}
+
+struct wrandbs *wrandbs_pool_local(struct wrandbs_pool *pool)
+{
+    return &pool->streams[pool_local_index(pool->owners, pool->n_streams,
+                                           &pool->n_claimed)];
+}
+
+void randbs_save(const struct randbs *bs, struct randbs_saved *saved)
+{
+    saved->state = bs->state;
+    saved->bits = bs->bits;
+    saved->n_bits = bs->n_bits;
+    saved->has_gauss_spare = bs->has_gauss_spare;
+    saved->gauss_spare = bs->gauss_spare;
+}
+
+void randbs_restore(struct randbs *bs, const struct randbs_saved *saved)
+{
+    bs->state = saved->state;
+    bs->bits = saved->bits;
+    bs->n_bits = saved->n_bits;
+    bs->has_gauss_spare = saved->has_gauss_spare;
+    bs->gauss_spare = saved->gauss_spare;
+}
+
+void randbs_pool_save(const struct randbs_pool *pool,
+                      struct randbs_saved *saved)
+{
+    size_t i;
+
+    for (i = 0; i < pool->n_streams; i++)
+        randbs_save(&pool->streams[i], &saved[i]);
+}
+
+void randbs_pool_restore(struct randbs_pool *pool,
+                         const struct randbs_saved *saved)
+{
+    size_t i;
+
+    for (i = 0; i < pool->n_streams; i++)
+        randbs_restore(&pool->streams[i], &saved[i]);
+}
+
+void wrandbs_save(const struct wrandbs *bs, struct wrandbs_saved *saved)
+{
+    saved->state = bs->state;
+    saved->bits = bs->bits;
+    saved->n_bits = bs->n_bits;
+    saved->has_gauss_spare = bs->has_gauss_spare;
+    saved->gauss_spare = bs->gauss_spare;
+}
+
+void wrandbs_restore(struct wrandbs *bs, const struct wrandbs_saved *saved)
+{
+    bs->state = saved->state;
+    bs->bits = saved->bits;
+    bs->n_bits = saved->n_bits;
+    bs->has_gauss_spare = saved->has_gauss_spare;
+    bs->gauss_spare = saved->gauss_spare;
+}
+
+void wrandbs_pool_save(const struct wrandbs_pool *pool,
+                       struct wrandbs_saved *saved)
+{
+    size_t i;
+
+    for (i = 0; i < pool->n_streams; i++)
+        wrandbs_save(&pool->streams[i], &saved[i]);
+}
+
+void wrandbs_pool_restore(struct wrandbs_pool *pool,
+                          const struct wrandbs_saved *saved)
+{
+    size_t i;
+
+    for (i = 0; i < pool->n_streams; i++)
+        wrandbs_restore(&pool->streams[i], &saved[i]);
 }
 
 void init_cdf(unsigned *cdf,
@@ -97,21 +585,216 @@ void init_cdf(unsigned *cdf,
     }
 }
 
+/* index of the first cdf entry greater than rand.  the loop is branchless
+ * apart from its own count, which only depends on n_elems */
+#define CDF_SEARCH(cdf, n_elems, rand) ({                       \
+    __auto_type _base = (cdf);                                  \
+    size_t _n = (n_elems);                                      \
+                                                                \
+    while (_n > 1) {                                            \
+        const size_t _half = _n / 2;                            \
+                                                                \
+        _base = _base[_half - 1] <= (rand) ? _base + _half : _base; \
+        _n -= _half;                                            \
+    }                                                           \
+    (size_t) (_base - (cdf)) + (_base[0] <= (rand));            \
+})
+
 unsigned sample_cdf(struct randbs *bs,
                     const unsigned *cdf, size_t n_elems)
 {
     uint32_t rand;
-    unsigned i;
+    size_t i;
+
+    rand = randbs_below32(bs, cdf[n_elems - 1]);
+    i = CDF_SEARCH(cdf, n_elems, rand);
+
+    assert(i < n_elems);
+    assert(rand < cdf[i]);
+    return i;
+}
+
+void init_cdf64(uint64_t *cdf,
+                const void *base, size_t n_elems, size_t elem_size,
+                size_t weight_offset)
+{
+    const uint8_t *data = base;
+    uint64_t sum = 0;
+    size_t i;
+
+    hard_assert(elem_size >= sizeof(uint64_t));
+
+    for (i = 0; i < n_elems; i++) {
+        const uint8_t *p = data + i * elem_size;
+        uint64_t w;
 
-    rand = randu32(bs, 0, cdf[n_elems - 1] - 1);
-    for (i = 0; i < n_elems && rand >= cdf[i]; i++)
-        ;
+        memcpy(&w, p + weight_offset, sizeof(w));
+        sum += w;
+        hard_assert(i == 0 || sum >= cdf[i - 1]); /* overflow detection */
+        cdf[i] = sum;
+    }
+}
+
+size_t sample_cdf64(struct randbs *bs,
+                    const uint64_t *cdf, size_t n_elems)
+{
+    uint64_t rand;
+    size_t i;
+
+    rand = randbs_below64(bs, cdf[n_elems - 1]);
+    i = CDF_SEARCH(cdf, n_elems, rand);
 
     assert(i < n_elems);
     assert(rand < cdf[i]);
     return i;
 }
 
+void alias_fini(struct alias_table *at)
+{
+    free(at->entries);
+    at->entries = NULL;
+    at->n_elems = 0;
+}
+
+unsigned alias_sample(struct randbs *bs, const struct alias_table *at)
+{
+    unsigned i;
+
+    alias_samplev(bs, at, &i, 1);
+    return i;
+}
+
+/* sample_floyd()'s set of chosen indices: open addressing, with Fibonacci
+ * hashing into 2^(64 - shift) slots.  no index can be UINT64_MAX, since
+ * they're all less than n, so that marks empty slots
+ */
+#define FLOYD_EMPTY (UINT64_MAX)
+
+static bool floyd_insert(uint64_t *set, unsigned shift, uint64_t v)
+{
+    const size_t mask = (UINT64_C(1) << (64 - shift)) - 1;
+    size_t h = (v * UINT64_C(0x9e3779b97f4a7c15)) >> shift;
+
+    for (; set[h] != FLOYD_EMPTY; h = (h + 1) & mask) {
+        if (set[h] == v)
+            return false;
+    }
+
+    set[h] = v;
+    return true;
+}
+
+int sample_floyd(struct randbs *bs, uint64_t *out, size_t k, uint64_t n)
+{
+    uint64_t *set, j;
+    size_t n_slots, m = 0;
+    unsigned shift;
+
+    hard_assert(k <= n);
+    if (!k) return 0;
+
+    /* at most half full */
+    for (n_slots = 2, shift = 63; n_slots < 2 * k; n_slots <<= 1)
+        shift--;
+
+    set = malloc(n_slots * sizeof(set[0]));
+    if (MALLOC_FAILED(!set)) return -1;
+    memset(set, 0xff, n_slots * sizeof(set[0]));
+
+    for (j = n - k; j < n; j++) {
+        uint64_t t = randbs_below64(bs, j + 1);
+
+        /* if t was already chosen, j can't have been */
+        if (!floyd_insert(set, shift, t)) {
+            t = j;
+            floyd_insert(set, shift, t);
+        }
+
+        out[m++] = t;
+    }
+
+    free(set);
+    return 0;
+}
+
+void sample_selection(struct randbs *bs, uint64_t *out, size_t k, uint64_t n)
+{
+    uint64_t t;
+    size_t m = 0;
+
+    hard_assert(k <= n);
+
+    /* index t is chosen with probability (still needed / still left) */
+    for (t = 0; m < k; t++) {
+        if (randbs_below64(bs, n - t) < k - m)
+            out[m++] = t;
+    }
+}
+
+/* uniform in (0, 1), for taking logs of */
+static double open_unit(struct randbs *bs)
+{
+    double u;
+
+    do {
+        u = randf64(bs, 0.0, 1.0);
+    } while (u == 0.0 || u == 1.0);
+
+    return u;
+}
+
+static void reservoir_advance(struct reservoir *r, struct randbs *bs)
+{
+    const uint64_t i = r->n_seen - 1;
+    double gap;
+
+    r->w *= exp(log(open_unit(bs)) / r->k);
+
+    /* items until the next one kept: geometric, with parameter w */
+    gap = floor(log(open_unit(bs)) / log1p(-r->w));
+
+    r->next = gap < (double) (UINT64_MAX - i - 1)
+              ? i + 1 + (uint64_t) gap
+              : UINT64_MAX;
+}
+
+void reservoir_init(struct reservoir *r, size_t k)
+{
+    r->k = k;
+    r->n_seen = 0;
+    r->next = k ? 0 : UINT64_MAX;
+    r->w = 1.0;
+}
+
+size_t reservoir_offer(struct reservoir *r, struct randbs *bs)
+{
+    const uint64_t i = r->n_seen++;
+    size_t slot;
+
+    if (i != r->next)
+        return RESERVOIR_SKIP;
+
+    if (i < r->k) {
+        slot = i;
+        if (i + 1 < r->k)
+            r->next = i + 1;
+        else
+            reservoir_advance(r, bs);
+    }
+    else {
+        slot = randbs_below64(bs, r->k);
+        reservoir_advance(r, bs);
+    }
+
+    return slot;
+}
+
+void reservoir_skip(struct reservoir *r, uint64_t n_items)
+{
+    hard_assert(n_items <= r->next - r->n_seen);
+    r->n_seen += n_items;
+}
+
 extern inline void state128_seed(struct state128 *restrict state,
                                  const struct state128 *seed);
 extern inline void state128_seed64(struct state128 *state, uint64_t seed);
@@ -133,9 +816,15 @@ extern inline float randf32(struct randbs *bs, double min, double max);
 extern inline double randf64(struct randbs *bs, double min, double max);
 
 extern inline bool coin(struct randbs *bs, float p_true);
+extern inline uint64_t coin_threshold(double p_true);
+extern inline bool coin_fixed(struct randbs *bs, uint64_t threshold);
 
-#if 0
-extern inline void wrandbs_seed(struct wrandbs *bs, const void *seed, size_t len);
+extern inline void state256_seed(struct state256 *restrict state,
+                                 const struct state256 *seed);
+extern inline void state256_seed64(struct state256 *state, uint64_t seed);
+
+extern inline void wrandbs_seed(struct wrandbs *bs,
+                                const struct state256 *seed);
 extern inline void wrandbs_seed64(struct wrandbs *bs, uint64_t seed);
 
 extern inline int32_t wrandi32(struct wrandbs *bs, int32_t min, int32_t max);
@@ -145,4 +834,4 @@ extern inline uint64_t wrandu64(struct wrandbs *bs, uint64_t min, uint64_t max);
 extern inline float wrandf32(struct wrandbs *bs, double min, double max);
 extern inline double wrandf64(struct wrandbs *bs, double min, double max);
 extern inline bool wcoin(struct wrandbs *bs, float p_true);
-#endif
+extern inline bool wcoin_fixed(struct wrandbs *bs, uint64_t threshold);
@@ -1,7 +1,13 @@
 extern "C" {
 #include "flrl/randutil.h"
 
+#include "flrl/parallel.h"
+#include "flrl/philox.h"
 #include "flrl/xassert.h"
+#include "flrl/xoshiro.h"
+
+extern void *randutil_malloc(size_t size);
+extern void randutil_free(void *ptr);
 }
 
 #include <algorithm>
@@ -26,7 +32,38 @@ constexpr unsigned rng_bits<struct randbs> = 32;
 template<>
 constexpr unsigned rng_bits<struct wrandbs> = 64;
 
+/* generator policies: how the engines refill a stream's bit buffer.
+ * gen_dynamic calls through the stream's func pointer, which works for any
+ * generator.  gen_inline bakes a specific generator into the engine, so its
+ * body can be inlined into the loops, but is only correct for streams that
+ * were set up with that generator.  both consume the stream identically,
+ * so calls using either can be freely mixed on the same stream.
+ */
 template<typename BS>
+struct gen_dynamic {
+    static inline auto next(BS *bs) { return bs->func(&bs->state); }
+};
+
+template<typename BS, auto F>
+struct gen_inline {
+    static inline auto next(BS *bs) { return F(&bs->state); }
+};
+
+using gen_xoshiro128plus = gen_inline<struct randbs,
+                                      xoshiro128plus_next_inline>;
+using gen_xoshiro128plusplus = gen_inline<struct randbs,
+                                          xoshiro128plusplus_next_inline>;
+using gen_xoshiro128starstar = gen_inline<struct randbs,
+                                          xoshiro128starstar_next_inline>;
+using gen_philox4x32 = gen_inline<struct randbs, philox4x32_next_inline>;
+using gen_xoshiro256plus = gen_inline<struct wrandbs,
+                                      xoshiro256plus_next_inline>;
+using gen_xoshiro256plusplus = gen_inline<struct wrandbs,
+                                          xoshiro256plusplus_next_inline>;
+using gen_xoshiro256starstar = gen_inline<struct wrandbs,
+                                          xoshiro256starstar_next_inline>;
+
+template<typename BS, typename G = gen_dynamic<BS>>
 static uint64_t bs_bits(BS *bs, unsigned want_bits)
 {
     uint64_t bits, extra = 0;
@@ -38,7 +75,7 @@ static uint64_t bs_bits(BS *bs, unsigned want_bits)
         uint64_t v;
         unsigned b;
 
-        v = bs->func(&bs->state);
+        v = G::next(bs);
         b = RANDBS_MAX_BITS - bs->n_bits;
 
         bs->bits |= v << bs->n_bits;
@@ -56,7 +93,7 @@ static uint64_t bs_bits(BS *bs, unsigned want_bits)
     return bits;
 }
 
-template<typename BS>
+template<typename BS, typename G = gen_dynamic<BS>>
 static unsigned bs_zeroes(BS *bs, unsigned limit)
 {
     unsigned zeroes = 0;
@@ -68,7 +105,7 @@ static unsigned bs_zeroes(BS *bs, unsigned limit)
         unsigned z, x;
 
         if (bs->n_bits == 0) {
-            bs->bits = bs->func(&bs->state);
+            bs->bits = G::next(bs);
             bs->n_bits = rng_bits<BS>;
         }
 
@@ -93,7 +130,57 @@ static unsigned bs_zeroes(BS *bs, unsigned limit)
     return zeroes;
 }
 
-template<typename BS, typename T>
+/* uniform value in [0, bound), by Lemire's nearly divisionless method:
+ * https://arxiv.org/abs/1805.10941
+ * the high half of random * bound is the result, and the low half tells
+ * whether it landed in one of the few overrepresented slots, which only
+ * needs checking (with a division) if it's less than bound.  random values
+ * are whole generator outputs, taken directly rather than through the bit
+ * buffer: one 32-bit output and a 64-bit product for bounds up to 2^32 on
+ * 32-bit generators, otherwise 64 random bits and a 128-bit product
+ */
+template<typename BS, typename G = gen_dynamic<BS>>
+static inline uint64_t bs_next64(BS *bs)
+{
+    if constexpr (rng_bits<BS> == 64) {
+        return G::next(bs);
+    }
+    else {
+        const uint64_t lo = G::next(bs);
+        return (uint64_t) G::next(bs) << 32 | lo;
+    }
+}
+
+template<typename BS, typename G = gen_dynamic<BS>>
+static inline uint64_t bs_below(BS *bs, uint64_t bound)
+{
+    if (rng_bits<BS> == 32 && bound <= UINT64_C(1) << 32) {
+        uint64_t m = (uint64_t) G::next(bs) * bound;
+
+        if ((uint32_t) m < bound) {
+            const uint64_t t = ((UINT64_C(1) << 32) - bound) % bound;
+
+            while ((uint32_t) m < t)
+                m = (uint64_t) G::next(bs) * bound;
+        }
+
+        return m >> 32;
+    }
+    else {
+        unsigned __int128 m = (unsigned __int128) bs_next64<BS, G>(bs) * bound;
+
+        if ((uint64_t) m < bound) {
+            const uint64_t t = -bound % bound;
+
+            while ((uint64_t) m < t)
+                m = (unsigned __int128) bs_next64<BS, G>(bs) * bound;
+        }
+
+        return m >> 64;
+    }
+}
+
+template<typename BS, typename T, typename G = gen_dynamic<BS>>
 static void randiv(BS *bs, T *out, std::size_t count, T min, T max)
 {
     using UT = std::make_unsigned_t<T>;
@@ -109,16 +196,22 @@ static void randiv(BS *bs, T *out, std::size_t count, T min, T max)
             out[i] = min;
         }
     }
+    else if (bs->int_method == RANDBS_INT_LEMIRE
+             && ((uint64_t) range & ((uint64_t) range + 1)) != 0) {
+        const uint64_t bound = (uint64_t) range + 1;
+
+        for (i = 0; i < count; i++) {
+            out[i] = min + bs_below<BS, G>(bs, bound);
+        }
+    }
     else {
         unsigned want_bits = std::bit_width(range);
 
-        /* XXX adjust want_bits for perverse cases? */
-
         for (i = 0; i < count; i++) {
             uint64_t v;
 
             do {
-                v = bs_bits(bs, want_bits);
+                v = bs_bits<BS, G>(bs, want_bits);
             } while (v > range);
 
             out[i] = min + v;
@@ -152,8 +245,41 @@ static constexpr unsigned extract_exp(T f)
     return (std::bit_cast<uintf<T>>(f) >> mantissa_bits<T>) & exp_mask<T>;
 }
 
+/* RANDBS_FLOAT_FAST: the top digits bits of one generator word (two
+ * 32-bit words for doubles from randbs) as a fraction in [0, 1).  words
+ * are drawn a block at a time and converted in a separate loop, which has
+ * no calls or branches so that it can be vectorized
+ */
+template<typename BS, typename T, typename G = gen_dynamic<BS>>
+static void randfv_fast(BS *bs, T *out, std::size_t count,
+                        double min, double range)
+{
+    using U = uintf<T>;
+    constexpr unsigned digits = std::numeric_limits<T>::digits;
+    constexpr unsigned shift = sizeof(U) * CHAR_BIT - digits;
+    constexpr double scale = 1.0 / (UINT64_C(1) << digits);
+    constexpr std::size_t block = 256;
+    U raw[block];
+    std::size_t i, j, n;
+
+    for (i = 0; i < count; i += n) {
+        n = std::min(block, count - i);
+
+        for (j = 0; j < n; j++) {
+            if constexpr (sizeof(U) == sizeof(uint64_t))
+                raw[j] = bs_next64<BS, G>(bs);
+            else
+                raw[j] = G::next(bs) >> (rng_bits<BS> - sizeof(U) * CHAR_BIT);
+        }
+
+        for (j = 0; j < n; j++)
+            out[i + j] = min + range * ((double) (std::make_signed_t<U>)
+                                        (raw[j] >> shift) * scale);
+    }
+}
+
 /* based on https://allendowney.com/research/rand/downey07randfloat.pdf */
-template<typename BS, typename T>
+template<typename BS, typename T, typename G = gen_dynamic<BS>>
 static void randfv(BS *bs, T *out, std::size_t count, double min, double max)
 {
     std::size_t i;
@@ -162,6 +288,11 @@ static void randfv(BS *bs, T *out, std::size_t count, double min, double max)
     const double range = max - min;
     hard_assert(range <= std::numeric_limits<T>::max());
 
+    if (bs->float_method == RANDBS_FLOAT_FAST) {
+        randfv_fast<BS, T, G>(bs, out, count, min, range);
+        return;
+    }
+
     /* we'll generate values in [0, 1], then scale and translate to [min,max]
      * we start with one less than the highest exponent because we may need
      * to add one later
@@ -175,14 +306,14 @@ static void randfv(BS *bs, T *out, std::size_t count, double min, double max)
         T val;
 
         /* choose random bits and decrement exponent until a 1 appears */
-        exponent = high_exp - bs_zeroes(bs, high_exp - low_exp);
+        exponent = high_exp - bs_zeroes<BS, G>(bs, high_exp - low_exp);
 
         /* choose a random mantissa */
-        mantissa = bs_bits(bs, mantissa_bits<T>);
+        mantissa = bs_bits<BS, G>(bs, mantissa_bits<T>);
 
         /* if the mantissa is zero, half the time we should move to the next
          * exponent range */
-        if (mantissa == 0 && bs_bits(bs, 1))
+        if (mantissa == 0 && bs_bits<BS, G>(bs, 1))
             exponent ++;
 
         /* combine the exponent and the mantissa */
@@ -193,7 +324,313 @@ static void randfv(BS *bs, T *out, std::size_t count, double min, double max)
     }
 }
 
-template<typename BS, typename T>
+/* ziggurat tables for the standard normal density f(x) = exp(-x*x/2), with
+ * 256 layers of equal area.  layer i is the rectangle [0, x[i]] by
+ * [f(x[i]), f(x[i + 1])], where x[1] = zig_r and x[256] = 0.  the bottom
+ * layer's rectangle instead has width x[0] = v / f(zig_r), so that its
+ * area includes the tail.
+ * zig_w[i] = x[i] / 2^52, zig_k[i] = x[i + 1] / x[i] * 2^52, zig_f[i] = f(x[i])
+ */
+static constexpr double zig_r = 3.6541528853610092;
+
+static constexpr uint64_t zig_k[256] = {
+    0xef33d8025ef65, 0xf1a5a4b331c4a, 0xf66c5f7f0302c, 0xf89fa48a41dfc,
+    0xf9e971e014597, 0xfac40582a2873, 0xfb606c4005433, 0xfbd6581c0b83a,
+    0xfc32b2f1e22ed, 0xfc7d26ecd2d22, 0xfcba8d85e11b1, 0xfcee204761f9e,
+    0xfd1a1a7b4c7ac, 0xfd40149e2f012, 0xfd613adbd650b, 0xfd7e6ef48cf04,
+    0xfd985e1b2ba75, 0xfdaf8f82e0282, 0xfdc46e529bf13, 0xfdd7509c63bfd,
+    0xfde87c57efeaa, 0xfdf82b02b71a9, 0xfe068c4ee67af, 0xfe13c82788314,
+    0xfe20003995557, 0xfe2b5122fe4fc, 0xfe35d35eeb19b, 0xfe3f9bffd1e37,
+    0xfe48bd436f458, 0xfe51470977280, 0xfe5947338f742, 0xfe60c9f38307e,
+    0xfe67da0b6abd8, 0xfe6e8102aa201, 0xfe74c751f6aa5, 0xfe7ab488233bf,
+    0xfe804f690a940, 0xfe859e07ab1ea, 0xfe8aa5dc4e8e6, 0xfe8f6bd76c5d6,
+    0xfe93f471d4729, 0xfe9843ba947a3, 0xfe9c5d62f563a, 0xfea044c8dd9f6,
+    0xfea3fcffd73e5, 0xfea788d8ee326, 0xfeaaeae992257, 0xfeae2591a02e9,
+    0xfeb13b00b2d4b, 0xfeb42d3ad1f9e, 0xfeb6fe1c98542, 0xfeb9af5ee0cdc,
+    0xfebc429a0b691, 0xfebeb948e6fd0, 0xfec114cb4b335, 0xfec356686c961,
+    0xfec57f50f31fe, 0xfec790a0da978, 0xfec98b61230c1, 0xfecb708956eb4,
+    0xfecd4100eb7b8, 0xfecefda07fe34, 0xfed0a732fe643, 0xfed23e76a2fd7,
+    0xfed3c41dea422, 0xfed538d06adff, 0xfed69d2b9c02b, 0xfed7f1c38a836,
+    0xfed937237e98d, 0xfeda6dce938c9, 0xfedb964042cf4, 0xfedcb0ece39d3,
+    0xfeddbe422047e, 0xfedebea76216c, 0xfedfb27e349cc, 0xfee09a22a1447,
+    0xfee175eb83c5a, 0xfee2462ad8205, 0xfee30b2e02ad7, 0xfee3c53e12c4f,
+    0xfee474a0006cf, 0xfee51994e57b6, 0xfee5b45a32889, 0xfee64529e007e,
+    0xfee6cc3a9bd5e, 0xfee749bff37ff, 0xfee7bdea7b888, 0xfee828e7f3dfd,
+    0xfee88ae369c79, 0xfee8e40557515, 0xfee93473c0a39, 0xfee97c524f2e3,
+    0xfee9bbc26af2e, 0xfee9f2e352025, 0xfeea21d22e4d9, 0xfeea48aa29e82,
+    0xfeea678481d24, 0xfeea7e7897653, 0xfeea8d9c0075e, 0xfeea95029640f,
+    0xfeea94be8333c, 0xfeea8ce04fa0a, 0xfeea7d76ed6f9, 0xfeea668fc2d71,
+    0xfeea4836b42ab, 0xfeea22762ccae, 0xfee9f557273f3, 0xfee9c0e13485b,
+    0xfee9851a829eb, 0xfee94207e25da, 0xfee8f7accc851, 0xfee8a60b66343,
+    0xfee84d2484ab3, 0xfee7ecf7b06b9, 0xfee7858327b81, 0xfee716c3e077a,
+    0xfee6a0b5897f0, 0xfee623528b42d, 0xfee59e9407f41, 0xfee51271db086,
+    0xfee47ee2982f3, 0xfee3e3db89b3d, 0xfee34150ae4bc, 0xfee29734b6524,
+    0xfee1e579006df, 0xfee12c0d95a06, 0xfee06ae124bc5, 0xfedfa1e0fd414,
+    0xfeded0f90997f, 0xfeddf813c8ad3, 0xfedd171a46e52, 0xfedc2df416652,
+    0xfedb3c8746ab3, 0xfeda42b85b705, 0xfed9406a42cc9, 0xfed8357e4a982,
+    0xfed721d414fe7, 0xfed605498c3dd, 0xfed4dfbad586e, 0xfed3b10242f4c,
+    0xfed278f844903, 0xfed1377358528, 0xfecfec47f91b7, 0xfece97488c8b3,
+    0xfecd38454fb16, 0xfecbcf0c427fe, 0xfeca5b6911f11, 0xfec8dd2500cb4,
+    0xfec75406ceef4, 0xfec5bfd29f196, 0xfec42049dafd3, 0xfec2752b15a14,
+    0xfec0be31ebde8, 0xfebefb16e2e3e, 0xfebd2b8f449cf, 0xfebb4f4cf9d7c,
+    0xfeb965fe62013, 0xfeb76f4e284f9, 0xfeb56ae3162b5, 0xfeb3585fe2a4a,
+    0xfeb13762fec12, 0xfeaf07865e63c, 0xfeacc85f3d91f, 0xfeaa797de1cef,
+    0xfea81a6d57419, 0xfea5aab32952d, 0xfea329cf166a4, 0xfea0973abe67b,
+    0xfe9df2694b6d5, 0xfe9b3ac714865, 0xfe986fb939aa1, 0xfe95909d388eb,
+    0xfe929cc879b1c, 0xfe8f9387d4ef6, 0xfe8c741f0cebc, 0xfe893dc840864,
+    0xfe85efb35173b, 0xfe8289053f08c, 0xfe7f08d774242, 0xfe7b6e37070a2,
+    0xfe77b823e9e39, 0xfe73e5900a702, 0xfe6ff55e5f4f1, 0xfe6be661e11ab,
+    0xfe67b75c6d578, 0xfe6366fd91077, 0xfe5ef3e13868a, 0xfe5a5c8e41212,
+    0xfe559f74ebc77, 0xfe50baed29524, 0xfe4bad34c095c, 0xfe46746d47734,
+    0xfe410e99ead7f, 0xfe3b799d0002b, 0xfe35b33558d4a, 0xfe2fb8fb54186,
+    0xfe29885da1b92, 0xfe231e9db1ca9, 0xfe1c78cbc3f99, 0xfe1593c28b84c,
+    0xfe0e6c225a259, 0xfe06fe4bc24f1, 0xfdff46599ed3e, 0xfdf7401a6b42f,
+    0xfdeee708d514e, 0xfde6364369f63, 0xfddd288342f8f, 0xfdd3b8118729d,
+    0xfdc9debb99a7d, 0xfdbf95c5bfcd1, 0xfdb4d5dc02e20, 0xfda9970105e8b,
+    0xfd9dd07a7add2, 0xfd9178bad2c8c, 0xfd848547b08e8, 0xfd76ea9c8e831,
+    0xfd689c08e99ed, 0xfd598b8920f53, 0xfd49a9990b479, 0xfd38e4ff0c91f,
+    0xfd272a8e2f450, 0xfd1464dd6c4e5, 0xfd007bf1dc931, 0xfceb54d8fec99,
+    0xfcd4d12f839c5, 0xfcbcce902231b, 0xfca325e4bde85, 0xfc87aa92896a5,
+    0xfc6a2977aee30, 0xfc4a67ae25bd2, 0xfc2821037a249, 0xfc03060ff6c58,
+    0xfbdab9d040bef, 0xfbaece9a1e50d, 0xfb7ec2366fe79, 0xfb49f8d5374c7,
+    0xfb0fb6718b90f, 0xfacf160d354dd, 0xfa86fde5b4bfa, 0xfa360f581fa74,
+    0xf9da907dbf50a, 0xf9724c74dd0db, 0xf8fa6578325e1, 0xf86f10c6357d6,
+    0xf7cb2ec28449f, 0xf707a755396a8, 0xf61a5e41ba39b, 0xf4f4695612562,
+    0xf37ed61ffcb1f, 0xf19470afa44b6, 0xeef4b817ecac9, 0xeb255e9d3f794,
+    0xe51f67ec1ef11, 0xda354fabd8190, 0xc08be98fbc783, 0x0000000000000,
+};
+
+static constexpr double zig_w[256] = {
+    8.683627060801317e-16, 8.1138493376564852e-16, 7.6589363708055728e-16,
+    7.3724243017987989e-16, 7.1599949348306652e-16, 6.9897183363876209e-16,
+    6.8468034175642597e-16, 6.7231504625055866e-16, 6.6138278850976642e-16,
+    6.5156033173449936e-16, 6.4262396595480554e-16, 6.344122407127506e-16,
+    6.2680469633012844e-16, 6.1970898945816265e-16, 6.1305272087252826e-16,
+    6.0677804093334505e-16, 6.0083796962719113e-16, 5.9519381496414471e-16,
+    5.8981331764779024e-16, 5.846692893455482e-16, 5.7973859457245966e-16,
+    5.7500137689198982e-16, 5.7044046212913911e-16, 5.6604089200824241e-16,
+    5.6178955535554176e-16, 5.5767489329265775e-16, 5.536866612467876e-16,
+    5.4981573508928141e-16, 5.4605395190747804e-16, 5.4239397822017123e-16,
+    5.3882920013340532e-16, 5.3535363118164969e-16, 5.3196183453384004e-16,
+    5.2864885695049451e-16, 5.2541017241775973e-16, 5.2224163380002343e-16,
+    5.1913943117576986e-16, 5.1610005577432282e-16, 5.1312026863067837e-16,
+    5.1019707323415618e-16, 5.0732769157335421e-16, 5.0450954308187285e-16,
+    5.0174022607180904e-16, 4.9901750130918225e-16, 4.9633927744039873e-16,
+    4.9370359802403345e-16, 4.9110862995952696e-16, 4.8855265313536034e-16,
+    4.860340511450812e-16, 4.8355130294115252e-16, 4.8110297531474172e-16,
+    4.7868771610487228e-16, 4.7630424805331374e-16, 4.7395136323258672e-16,
+    4.7162791798383513e-16, 4.6933282830933289e-16, 4.6706506567126306e-16,
+    4.6482365315432074e-16, 4.6260766195478457e-16, 4.6041620816311528e-16,
+    4.5824844981095667e-16, 4.5610358415674221e-16, 4.539808451870034e-16,
+    4.5187950131300588e-16, 4.4979885324455497e-16, 4.4773823202475339e-16,
+    4.4569699721120431e-16, 4.4367453519065673e-16, 4.4167025761542035e-16,
+    4.3968359995105214e-16, 4.3771402012585875e-16, 4.357609972736849e-16,
+    4.3382403056227908e-16, 4.3190263810026294e-16, 4.2999635591638323e-16,
+    4.2810473700531167e-16, 4.2622735043477981e-16, 4.243637805093078e-16,
+    4.2251362598620494e-16, 4.2067649933990151e-16, 4.1885202607101123e-16,
+    4.1703984405683159e-16, 4.1523960294026883e-16, 4.1345096355442365e-16,
+    4.1167359738030262e-16, 4.0990718603532674e-16, 4.0815142079049397e-16,
+    4.0640600211422519e-16, 4.0467063924107514e-16, 4.0294504976363294e-16,
+    4.0122895924606306e-16, 3.995221008578566e-16, 3.9782421502646836e-16,
+    3.9613504910761364e-16, 3.9445435707208786e-16, 3.927818992080543e-16,
+    3.9111744183782064e-16, 3.8946075704819272e-16, 3.8781162243355877e-16,
+    3.8616982085091503e-16, 3.8453514018609605e-16, 3.8290737313052447e-16,
+    3.8128631696783794e-16, 3.7967177336979462e-16, 3.7806354820089623e-16,
+    3.7646145133120307e-16, 3.7486529645684912e-16, 3.732749009277946e-16,
+    3.716900855823825e-16, 3.7011067458829008e-16, 3.6853649528949165e-16,
+    3.6696737805887039e-16, 3.6540315615613729e-16, 3.6384366559073478e-16,
+    3.622887449894195e-16, 3.6073823546823548e-16, 3.5919198050860329e-16,
+    3.576498258372653e-16, 3.5611161930983909e-16, 3.5457721079774382e-16,
+    3.5304645207827426e-16, 3.5151919672760769e-16, 3.499953000165384e-16,
+    3.4847461880874167e-16, 3.4695701146137865e-16, 3.4544233772785865e-16,
+    3.4393045866258338e-16, 3.4242123652750211e-16, 3.409145347003129e-16,
+    3.3941021758414921e-16, 3.3790815051859528e-16, 3.364081996918768e-16,
+    3.3491023205407819e-16, 3.3341411523123754e-16, 3.3191971744017558e-16,
+    3.3042690740391323e-16, 3.2893555426753736e-16, 3.2744552751437102e-16,
+    3.2595669688230818e-16, 3.2446893228017012e-16, 3.229821037039419e-16,
+    3.2149608115274505e-16, 3.2001073454440148e-16, 3.1852593363044099e-16,
+    3.170415479104032e-16, 3.1555744654528046e-16, 3.1407349826994501e-16,
+    3.1258957130440029e-16, 3.1110553326368969e-16, 3.0962125106629265e-16,
+    3.0813659084083006e-16, 3.066514178308958e-16, 3.0516559629782222e-16,
+    3.0367898942118048e-16, 3.021914591968065e-16, 3.007028663321334e-16,
+    2.992130701386016e-16, 2.9772192842090319e-16, 2.9622929736280689e-16,
+    2.9473503140929379e-16, 2.9323898314471846e-16, 2.917410031666948e-16,
+    2.9024093995538448e-16, 2.8873863973784844e-16, 2.8723394634709824e-16,
+    2.857267010754604e-16, 2.842167425218409e-16, 2.8270390643244822e-16,
+    2.8118802553450237e-16, 2.796689293624233e-16, 2.7814644407595471e-16,
+    2.7662039226963933e-16, 2.7509059277301701e-16, 2.735568604408682e-16,
+    2.720190059327735e-16, 2.7047683548119981e-16, 2.6893015064726189e-16,
+    2.6737874806323667e-16, 2.6582241916083103e-16, 2.6426094988411925e-16,
+    2.6269412038597286e-16, 2.6112170470670223e-16, 2.5954347043351737e-16,
+    2.5795917833928702e-16, 2.5636858199894003e-16, 2.5477142738169481e-16,
+    2.5316745241713617e-16, 2.5155638653296618e-16, 2.4993795016204569e-16,
+    2.4831185421610916e-16, 2.4667779952327094e-16, 2.4503547622614998e-16,
+    2.4338456313711073e-16, 2.417247270467507e-16, 2.4005562198135107e-16,
+    2.3837688840454288e-16, 2.3668815235791648e-16, 2.3498902453471004e-16,
+    2.3327909928004405e-16, 2.3155795351040853e-16, 2.2982514554424738e-16,
+    2.280802138345023e-16, 2.2632267559285733e-16, 2.2455202529414405e-16,
+    2.2276773304789603e-16, 2.2096924282235367e-16, 2.191559705042732e-16,
+    2.1732730177564414e-16, 2.1548258978581505e-16, 2.1362115259449915e-16,
+    2.1174227035760391e-16, 2.0984518222370401e-16, 2.0792908290414067e-16,
+    2.0599311887403756e-16, 2.0403638415480261e-16, 2.0205791562071703e-16,
+    2.0005668776273379e-16, 1.9803160683128228e-16, 1.9598150426628879e-16,
+    1.939051293062516e-16, 1.9180114064838679e-16, 1.8966809700774819e-16,
+    1.8750444639373941e-16, 1.8530851388618081e-16, 1.8307848764826812e-16,
+    1.8081240285799216e-16, 1.7850812316976796e-16, 1.7616331923001065e-16,
+    1.7377544365864928e-16, 1.7134170176559727e-16, 1.6885901708676668e-16,
+    1.6632399058420909e-16, 1.637328520396993e-16, 1.6108140175275009e-16,
+    1.5836494009290964e-16, 1.5557818169460848e-16, 1.5271515003596284e-16,
+    1.4976904668391123e-16, 1.4673208742364508e-16, 1.4359529452057037e-16,
+    1.4034823001242476e-16, 1.3697864842571299e-16, 1.3347203736824219e-16,
+    1.2981099886264135e-16, 1.2597439914637204e-16, 1.2193617278714484e-16,
+    1.1766359457023049e-16, 1.1311470196109169e-16, 1.0823430288447832e-16,
+    1.0294750314241179e-16, 9.7148600765679418e-17, 9.0680604050596857e-17,
+    8.3293668157933327e-17, 7.4548704812479761e-17, 6.3543524174056296e-17,
+    4.7793301757283223e-17,
+};
+
+static constexpr double zig_f[257] = {
+    0.0004774677646093862, 0.0012602859304985956, 0.0026090727461021593,
+    0.0040379725933630236, 0.0055224032992509864, 0.0070508754713732164,
+    0.0086165827693987194, 0.010214971439701459, 0.011842757857907879,
+    0.013497450601739867, 0.015177088307935309, 0.016880083152543142,
+    0.018605121275724622, 0.020351096230044483, 0.022117062707308819,
+    0.023902203305795823, 0.025705804008548817, 0.027527235669603013,
+    0.029365939758133255, 0.031221417191920189, 0.03309321945857846,
+    0.034980941461716021, 0.036884215688567222, 0.038802707404526064,
+    0.040736110655940898, 0.042684144916474424, 0.044646552251294463,
+    0.046623094901930381, 0.048613553215868542, 0.050617723860947782,
+    0.05263541827679219, 0.054666461324888921, 0.056710690106202902,
+    0.058767952920933737, 0.060838108349539878, 0.062921024437758141,
+    0.065016577971242898, 0.067124653827788497, 0.069245144397006755,
+    0.071377949058890403, 0.073522973713981324, 0.075680130358927108,
+    0.077849336702096053, 0.08003051581466307, 0.082223595813202904,
+    0.084428509570353472, 0.086645194450558072, 0.088873592068275886,
+    0.091113648066373759, 0.093365311912691012, 0.095628536713008999,
+    0.097903279038862465, 0.10018949876881002, 0.10248715894193525,
+    0.10479622562248707, 0.1071166677746838, 0.1094484571468118,
+    0.11179156816383809, 0.11414597782783849, 0.11651166562561087,
+    0.11888861344291006, 0.12127680548479031, 0.12367622820159657,
+    0.12608687022018589, 0.12850872227999957, 0.13094177717364436,
+    0.13338602969166916, 0.13584147657125376, 0.13830811644855073,
+    0.1407859498144447, 0.14327497897351346, 0.14577520800599403,
+    0.14828664273257455, 0.15080929068184568, 0.15334316106026286,
+    0.1558882647244792, 0.15844461415592428, 0.16101222343751101,
+    0.16359110823236558, 0.16618128576448191, 0.16878277480121129,
+    0.17139559563750575, 0.17401977008183855, 0.17665532144373478,
+    0.1793022745228475, 0.18196065559952238, 0.1846304924267991,
+    0.18731181422380005, 0.19000465167046479, 0.19270903690358893,
+    0.19542500351413411, 0.19815258654577494, 0.20089182249465645,
+    0.20364274931033471, 0.20640540639788052, 0.20917983462112485,
+    0.21196607630703004, 0.21476417525117344, 0.21757417672433102,
+    0.22039612748015178, 0.22323007576391726, 0.22607607132237997,
+    0.22893416541467998, 0.23180441082433836, 0.23468686187232965,
+    0.23758157443123773, 0.24048860594050009, 0.2434080154227499,
+    0.24633986350126344, 0.24928421241852802, 0.25224112605594168,
+    0.25521066995466141, 0.25819291133761862, 0.26118791913272055,
+    0.26419576399726047, 0.2672165183435608, 0.27025025636587496,
+    0.27329705406857657, 0.27635698929566782, 0.27943014176163744,
+    0.28251659308370708, 0.2856164268155012, 0.28872972848218231,
+    0.2918565856170946, 0.29499708779996126, 0.29815132669668498,
+    0.30131939610080249, 0.30450139197664938, 0.30769741250429145,
+    0.3109075581262859, 0.31413193159633651, 0.31737063802991289,
+    0.32062378495690469, 0.32389148237639043, 0.32717384281360057,
+    0.33047098137916275, 0.33378301583071757, 0.33711006663700532,
+    0.34045225704452103, 0.34380971314684994, 0.34718256395679287,
+    0.35057094148140533, 0.35397498080007594, 0.35739482014577972,
+    0.3608306009896472, 0.36428246812900311, 0.36775056977903164,
+    0.37123505766823856, 0.37473608713789019, 0.3782538172456183,
+    0.38178841087339283, 0.38534003484007651, 0.38890886001878799,
+    0.39249506145931484, 0.39609881851583162, 0.3997203149801965,
+    0.40335973922111379, 0.40701728432947265, 0.41069314827018755,
+    0.4143875340408904, 0.4181006498378475, 0.42183270922949528,
+    0.4255839313380213, 0.42935454102944082, 0.43314476911265165,
+    0.43695485254798488, 0.44078503466580327, 0.44463556539573862,
+    0.44850670150720229, 0.4523987068618478, 0.45631185267871566,
+    0.46024641781284209, 0.46420268904817352, 0.46818096140569282,
+    0.47218153846772942, 0.47620473271950514, 0.48025086590904598,
+    0.48432026942668244, 0.4884132847054572, 0.49253026364386776,
+    0.49667156905248894, 0.5008375751261479, 0.50502866794346735,
+    0.50924524599574705, 0.51348772074732596, 0.51775651722975535,
+    0.52205207467232084, 0.52637484717168337, 0.53072530440366095,
+    0.5351039323804565, 0.53951123425695091, 0.54394773119002504,
+    0.54841396325526459, 0.55291049042583107, 0.55743789361876472,
+    0.56199677581452323, 0.56658776325616311, 0.57121150673525189,
+    0.57586868297235239, 0.58055999610078957, 0.5852861792633699,
+    0.59004799633282445, 0.594846243767986, 0.59968175261912393,
+    0.60455539069746644, 0.6094680649257721, 0.61442072388891256,
+    0.61941436060583299, 0.62445001554702517, 0.62952877992483536,
+    0.63465179928762228, 0.63982027745305525, 0.64503548082082096,
+    0.65029874311081537, 0.65561147057969593, 0.66097514777666178,
+    0.66639134390874877, 0.67186171989708066, 0.67738803621877197,
+    0.6829721616449933, 0.68861608300467025, 0.69432191612611516,
+    0.70009191813651006, 0.70592850133275264, 0.71183424887824676,
+    0.7178119326307203, 0.72386453346862845, 0.72999526456147446,
+    0.73620759812686087, 0.74250529634014928, 0.74889244721915504,
+    0.75537350650709423, 0.76195334683679339, 0.76863731579848427,
+    0.77543130498118518, 0.7823418326548004, 0.78937614356602248,
+    0.79654233042295686, 0.80384948317096216, 0.81130787431265405,
+    0.81892919160370015, 0.82672683394621915, 0.83471629298688121,
+    0.84291565311220185, 0.85134625845867551, 0.86003362119632898,
+    0.86900868803685438, 0.87830965580891462, 0.88798466075583049,
+    0.89809592189834042, 0.90872644005212766, 0.91999150503934357,
+    0.9320600759592268, 0.94519895344229565, 0.95987909180010211,
+    0.97710170126766605, 1,
+};
+
+/* Marsaglia & Tsang, "The Ziggurat Method for Generating Random Variables"
+ * https://www.jstatsoft.org/v05/i08
+ * one draw picks a layer, a sign, and a position within the layer.  if the
+ * position is inside the next layer's width, it's under the curve and we're
+ * done.  otherwise it's in the wedge (or for the bottom layer, the tail),
+ * which needs a second uniform and an exp (or two logs) to decide.
+ * position gets the same number of bits as T's mantissa
+ */
+template<typename BS, typename T, typename G = gen_dynamic<BS>>
+static double zig_normal(BS *bs)
+{
+    constexpr unsigned pos_bits = mantissa_bits<T>;
+
+    for (;;) {
+        const uint64_t r = bs_bits<BS, G>(bs, 8 + 1 + pos_bits);
+        const unsigned i = r & 0xff;
+        const bool negative = r & 0x100;
+        const uint64_t pos = (r >> 9) << (52 - pos_bits);
+        double x = pos * zig_w[i];
+
+        if (pos < zig_k[i]) {
+            /* common case */
+        }
+        else if (i == 0) {
+            double xx, yy;
+
+            /* log(0) makes xx or yy infinite, which is handled correctly:
+             * infinite xx is rejected, and infinite yy accepts any xx
+             */
+            do {
+                T u[2];
+
+                randfv<BS, T, G>(bs, u, 2, 0.0, 1.0);
+                xx = -randutil_log(u[0]) / zig_r;
+                yy = -randutil_log(u[1]);
+            } while (yy + yy < xx * xx);
+
+            x = zig_r + xx;
+        }
+        else {
+            T u;
+
+            randfv<BS, T, G>(bs, &u, 1, 0.0, 1.0);
+            if (randutil_fma(u, zig_f[i + 1] - zig_f[i], zig_f[i])
+                >= randutil_exp(-0.5 * x * x))
+                continue;
+        }
+
+        return negative ? -x : x;
+    }
+}
+
+template<typename BS, typename T, typename G = gen_dynamic<BS>>
 static void gaussv(BS *bs,
                    T *out,
                    std::size_t count,
@@ -202,13 +639,30 @@ static void gaussv(BS *bs,
 {
     std::size_t i;
 
-    for (i = 0; i < count; i += 2) {
+    if (bs->gauss_method == RANDBS_GAUSS_ZIGGURAT) {
+        for (i = 0; i < count; i++) {
+            out[i] = randutil_fma(stddev, zig_normal<BS, T, G>(bs), mean);
+        }
+        return;
+    }
+
+    /* polar deviates come in pairs.  if the last call left one over, it
+     * goes first, and if this call leaves one over, it's kept for the next.
+     * so the sequence doesn't depend on how it's split into calls
+     */
+    i = 0;
+    if (count && bs->has_gauss_spare) {
+        out[i++] = randutil_fma(stddev, bs->gauss_spare, mean);
+        bs->has_gauss_spare = false;
+    }
+
+    for (; i < count; i += 2) {
         double v[2], s, t;
 
         do {
             T u[2];
 
-            randfv(bs, u, 2, 0.0, 1.0);
+            randfv<BS, T, G>(bs, u, 2, 0.0, 1.0);
 
             v[0] = randutil_fma(2.0, u[0], -1.0);
             v[1] = randutil_fma(2.0, u[1], -1.0);
@@ -218,45 +672,1156 @@ static void gaussv(BS *bs,
         t = randutil_sqrt(-2.0 * randutil_log(s) / s);
 
         out[i] = randutil_fma(stddev, v[0] * t, mean);
-        if (i + 1 < count)
+        if (i + 1 < count) {
             out[i + 1] = randutil_fma(stddev, v[1] * t, mean);
+        }
+        else {
+            bs->gauss_spare = v[1] * t;
+            bs->has_gauss_spare = true;
+        }
     }
 }
 
 template<typename BS, typename T>
 static T gauss(BS *bs, double mean, double stddev)
 {
-    static double v[2], t;
-    static int phase = 0;
-    double x;
+    T x;
 
-    if (0 == phase) {
-        double s;
+    gaussv(bs, &x, 1, mean, stddev);
+    return x;
+}
 
-        do {
-            T u[2];
+/* ziggurat tables for the standard exponential density f(x) = exp(-x),
+ * laid out the same way as the normal ones above, with x[1] = ezig_r
+ */
+static constexpr double ezig_r = 7.697117470131049;
+
+static constexpr uint64_t ezig_k[256] = {
+    0xe290a13924be4, 0xe6da6ecf27460, 0xeeefb15d605d8, 0xf2cb0e3c5933e,
+    0xf51530f0916d9, 0xf69c650c40a8f, 0xf7b577d2be5f3, 0xf889f023d820a,
+    0xf930a1a281a04, 0xf9b72d1c52cd1, 0xfa263b32e37ed, 0xfa839276708b9,
+    0xfad334827f1e3, 0xfb18000547133, 0xfb5411a5b9a96, 0xfb890078d120e,
+    0xfbb8051ac1566, 0xfbe213c1cf493, 0xfc07ee19b01ce, 0xfc2a2fc826dc8,
+    0xfc4957623cb04, 0xfc65ccf39c2fc, 0xfc7fe6d4d720e, 0xfc97ed4e778f9,
+    0xfcae1d5e81fbc, 0xfcc2aadbc17dc, 0xfcd5c220ad5e2, 0xfce7895bcfcde,
+    0xfcf8219b5df05, 0xfd07a7a3ef98b, 0xfd16349e2e04a, 0xfd23dea45f500,
+    0xfd30b9368f90a, 0xfd3cd59a8469e, 0xfd48432b7b351, 0xfd530f9ccff94,
+    0xfd5d473200305, 0xfd66f4edf96b9, 0xfd7022bb3f083, 0xfd78d98e23cd3,
+    0xfd812182170e1, 0xfd8901f2d4b02, 0xfd9081922142a, 0xfd97a67a9ce20,
+    0xfd9e76401f3a3, 0xfda4f5fdfb4e9, 0xfdab2a6379bf1, 0xfdb117becb4a1,
+    0xfdb6c206aaaca, 0xfdbc2ce2dc4ae, 0xfdc15bb3b2daa, 0xfdc65198ba50c,
+    0xfdcb1176a55fe, 0xfdcf9dfc95b0d, 0xfdd3f9a8d3856, 0xfdd826cd068c7,
+    0xfddc2791ff351, 0xfddffdfb1dbd5, 0xfde3abe9626f2, 0xfde7331e3100d,
+    0xfdea953dcfc13, 0xfdedd3d1aa204, 0xfdf0f04a5d30a, 0xfdf3ec0193eee,
+    0xfdf6c83bb8663, 0xfdf986297e305, 0xfdfc26e94a448, 0xfdfeab887b95d,
+    0xfe011504979b2, 0xfe03644c5d7f8, 0xfe059a40c26d2, 0xfe07b7b5d920a,
+    0xfe09bd73a6b5c, 0xfe0bac36e6688, 0xfe0d84b1bdd9e, 0xfe0f478c633ab,
+    0xfe10f565b69cf, 0xfe128ed3cf8b2, 0xfe1414647fe78, 0xfe15869dccfd0,
+    0xfe16e5fe5f932, 0xfe1832fdebc44, 0xfe196e0d9140d, 0xfe1a9798349b9,
+    0xfe1bb002d22ca, 0xfe1cb7accb0a6, 0xfe1daef02c8da, 0xfe1e9621f2c9e,
+    0xfe1f6d92465b1, 0xfe20358cb5dfb, 0xfe20ee586b707, 0xfe2198385e5cd,
+    0xfe22336b81711, 0xfe22c02cee01c, 0xfe233eb40bf41, 0xfe23af34b6f73,
+    0xfe2411df611bd, 0xfe2466e132f60, 0xfe24ae64296fa, 0xfe24e88f316f1,
+    0xfe2515864173b, 0xfe25356a71450, 0xfe25485a0fd1a, 0xfe254e70b7550,
+    0xfe2547c75fdc6, 0xfe253474703fe, 0xfe25148bcda1a, 0xfe24e81ee9859,
+    0xfe24af3cce90d, 0xfe2469f22bffb, 0xfe2418495fddd, 0xfe23ba4a800d9,
+    0xfe234ffb62282, 0xfe22d95fa23f4, 0xfe225678a8895, 0xfe21c745adfe3,
+    0xfe212bc3bfeb4, 0xfe2083edc2830, 0xfe1fcfbc726d4, 0xfe1f0f26655a0,
+    0xfe1e4220099a5, 0xfe1d689ba4bfd, 0xfe1c828951443, 0xfe1b8fd6fb37c,
+    0xfe1a90705bf64, 0xfe19843ef4e07, 0xfe186b2a09177, 0xfe1745169635a,
+    0xfe1611e74c023, 0xfe14d17c83188, 0xfe1383b4327e1, 0xfe122869e4200,
+    0xfe10bf76a82ef, 0xfe0f48b107521, 0xfe0dc3ecf3a5a, 0xfe0c30fbb87a6,
+    0xfe0a8fabe8ca1, 0xfe08dfc94c532, 0xfe07211ccb4c5, 0xfe05536c58a14,
+    0xfe03767adaa5a, 0xfe018a08122c4, 0xfdff8dd07fed9, 0xfdfd818d48262,
+    0xfdfb64f414571, 0xfdf937b6f30ba, 0xfdf6f98435894, 0xfdf4aa064b4b0,
+    0xfdf248e39b26f, 0xfdefd5be59fa1, 0xfded50345eb36, 0xfdeab7def394e,
+    0xfde80c52a47d0, 0xfde54d1f0a06a, 0xfde279ce914cb, 0xfddf91e64014e,
+    0xfddc94e575272, 0xfdd98245a48a2, 0xfdd6597a0f60b, 0xfdd319ef77143,
+    0xfdcfc30bcb793, 0xfdcc542dd3902, 0xfdc8ccacd07ba, 0xfdc52bd81a3fb,
+    0xfdc170f6b5d05, 0xfdbd9b46e3ed4, 0xfdb9a9fda83cc, 0xfdb59c4648085,
+    0xfdb17141bff2d, 0xfdad28062fed5, 0xfda8bf9e3c9ff, 0xfda437086566b,
+    0xfd9f8d364df06, 0xfd9ac10bfa70c, 0xfd95d15efd425, 0xfd90bcf594b1c,
+    0xfd8b8285b78fe, 0xfd8620b40effa, 0xfd809612dbd09, 0xfd7ae120c583f,
+    0xfd75004790eb6, 0xfd6ef1dabc161, 0xfd68b415fcff5, 0xfd62451ba02c2,
+    0xfd5ba2f2c4118, 0xfd54cb856dc2c, 0xfd4dbc9e72ff8, 0xfd4673e73543b,
+    0xfd3eeee528f62, 0xfd372af7233c1, 0xfd2f2552684bf, 0xfd26daff73551,
+    0xfd1e48d670341, 0xfd156b7b5e27e, 0xfd0c3f59d199d, 0xfd02c0a049b60,
+    0xfcf8eb3b0d0e7, 0xfceebace7ec02, 0xfce42ab0db8bd, 0xfcd935e34bf80,
+    0xfccdd70a35d40, 0xfcc20864b4448, 0xfcb5c3c319c4a, 0xfca9027c5b26d,
+    0xfc9bbd623d7eb, 0xfc8decb41ac71, 0xfc7f881009f0b, 0xfc7086622e825,
+    0xfc60ddd1e9cd6, 0xfc5083ac9ba7e, 0xfc3f6c4d92131, 0xfc2d8b02b5c89,
+    0xfc1ad1ed6c8b1, 0xfc0731df1089c, 0xfbf29a303cfc5, 0xfbdcf89209ffa,
+    0xfbc638d822e60, 0xfbae44ba684ec, 0xfb95038c8789c, 0xfb7a59e99727a,
+    0xfb5e295158173, 0xfb404fb42cb3d, 0xfb20a6ea22bb8, 0xfaff041086847,
+    0xfadb36c84ccca, 0xfab5084e1f660, 0xfa8c3a62e1991, 0xfa6085f8e9d08,
+    0xfa319996bc47d, 0xf9ff175b734a6, 0xf9c8928abe083, 0xf98d8c7dcaa9a,
+    0xf94d70ca8d43a, 0xf9079062292b8, 0xf8bb1b4f8fbbd, 0xf867189d3cb5a,
+    0xf80a5bb6eea51, 0xf7a37651b0e67, 0xf730a57372b44, 0xf6afb7843cce6,
+    0xf61de83da32ab, 0xf577ad8a7784f, 0xf4b86d784571e, 0xf3da104b78236,
+    0xf2d458bbe5bd0, 0xf19bdb8ea3c1a, 0xf0204efd64ee4, 0xee49a6e8b9637,
+    0xebf2deab58c59, 0xe8dff16ae1cb8, 0xe4a8e87c43289, 0xde893fb8ca239,
+    0xd4ddb9907584d, 0xc377ac71f9df4, 0x9beadebce1890, 0x0000000000000,
+};
+
+static constexpr double ezig_w[256] = {
+    1.9311480126418366e-15, 1.7091034077168053e-15, 1.5412190700064192e-15,
+    1.4384889932178721e-15, 1.3642786158057855e-15, 1.306098410712808e-15,
+    1.2581958069755112e-15, 1.2174462832361813e-15, 1.1819635283304202e-15,
+    1.1505212963006659e-15, 1.1222774909350315e-15, 1.0966288068517404e-15,
+    1.0731281954224039e-15, 1.0514351604044548e-15, 1.0312843657756164e-15,
+    1.0124650144288317e-15, 9.9480684723838775e-16, 9.7817036547844159e-16,
+    9.6243983456584719e-16, 9.4751817065249821e-16, 9.3332313294229496e-16,
+    9.197844409811863e-16, 9.068415597131667e-16, 8.9444197485198626e-16,
+    8.8253983380721388e-16, 8.710948629387902e-16, 8.6007149633349394e-16,
+    8.4943816836487681e-16, 8.3916673441467959e-16, 8.2923199285818072e-16,
+    8.196112877806123e-16, 8.1028417659131444e-16, 8.0123215021130814e-16,
+    7.924383961573548e-16, 7.8388759686228558e-16, 7.7556575712157886e-16,
+    7.6746005575784254e-16, 7.5955871753377468e-16, 7.5185090208325101e-16,
+    7.4432660721604126e-16, 7.3697658441912397e-16, 7.2979226475290831e-16,
+    7.2276569364381182e-16, 7.1588947332085501e-16, 7.0915671184495808e-16,
+    7.0256097784459559e-16, 6.9609626020748816e-16, 6.8975693209068458e-16,
+    6.835377187051271e-16, 6.7743366840910074e-16, 6.7144012671064862e-16,
+    6.6555271283433408e-16, 6.5976729855445643e-16, 6.5407998903644789e-16,
+    6.4848710546189013e-16, 6.4298516924135927e-16, 6.3757088764394243e-16,
+    6.3224114069342095e-16, 6.2699296919933243e-16, 6.2182356380685297e-16,
+    6.167302549630617e-16, 6.1171050370897178e-16, 6.0676189321700029e-16,
+    6.0188212100252333e-16, 5.9706899174600876e-16, 5.9232041066909284e-16,
+    5.8763437741400533e-16, 5.8300898038105834e-16, 5.7844239148359882e-16,
+    5.7393286128396324e-16, 5.6947871447763452e-16, 5.6507834569605034e-16,
+    5.607302156013963e-16, 5.5643284724928682e-16, 5.5218482269752303e-16,
+    5.4798477984116267e-16, 5.438314094559634e-16, 5.3972345243389749e-16,
+    5.3565969719590474e-16, 5.3163897726836873e-16, 5.2766016901098827e-16,
+    5.2372218948478465e-16, 5.1982399444994909e-16, 5.1596457648410598e-16,
+    5.1214296321235395e-16, 5.0835821564116225e-16, 5.0460942658884321e-16,
+    5.0089571920591121e-16, 4.9721624557917025e-16, 4.9357018541385765e-16,
+    4.8995674478861394e-16, 4.8637515497845099e-16, 4.8282467134125846e-16,
+    4.7930457226372461e-16, 4.7581415816285524e-16, 4.723527505395547e-16,
+    4.6891969108099147e-16, 4.6551434080870682e-16, 4.6213607926964256e-16,
+    4.5878430376746207e-16, 4.5545842863172401e-16, 4.5215788452263455e-16,
+    4.4888211776926152e-16, 4.4563058973923601e-16, 4.4240277623809909e-16,
+    4.3919816693657405e-16, 4.3601626482415671e-16, 4.328565856875209e-16,
+    4.2971865761233261e-16, 4.2660202050715577e-16, 4.2350622564821513e-16,
+    4.2043083524385851e-16, 4.1737542201763194e-16, 4.1433956880894736e-16,
+    4.1132286819038353e-16, 4.0832492210071775e-16, 4.0534534149283966e-16,
+    4.0238374599574688e-16, 3.9943976358986837e-16, 3.9651303029500381e-16,
+    3.9360318987020748e-16, 3.9070989352498183e-16, 3.8783279964117988e-16,
+    3.8497157350504876e-16, 3.8212588704887526e-16, 3.7929541860172334e-16,
+    3.7647985264877841e-16, 3.7367887959883854e-16, 3.7089219555951389e-16,
+    3.6811950211971757e-16, 3.6536050613905045e-16, 3.6261491954370036e-16,
+    3.5988245912849279e-16, 3.5716284636474657e-16, 3.5445580721360135e-16,
+    3.5176107194449833e-16, 3.4907837495850684e-16, 3.4640745461620172e-16,
+    3.4374805306980638e-16, 3.4109991609932602e-16, 3.384627929524045e-16,
+    3.3583643618764582e-16, 3.3322060152114846e-16, 3.3061504767600748e-16,
+    3.2801953623454369e-16, 3.2543383149302615e-16, 3.2285770031865578e-16,
+    3.202909120085834e-16, 3.1773323815073688e-16, 3.1518445248623533e-16,
+    3.126443307731676e-16, 3.1011265065151553e-16, 3.0758919150899944e-16,
+    3.0507373434762521e-16, 3.0256606165070793e-16, 3.0006595725014744e-16,
+    2.9757320619372521e-16, 2.9508759461219038e-16, 2.9260890958589519e-16,
+    2.9013693901073759e-16, 2.8767147146315809e-16, 2.8521229606393309e-16,
+    2.8275920234049704e-16, 2.8031198008751431e-16, 2.7787041922541278e-16,
+    2.7543430965657624e-16, 2.7300344111887955e-16, 2.7057760303623504e-16,
+    2.6815658436579984e-16, 2.6574017344147618e-16, 2.6332815781331447e-16,
+    2.6092032408240577e-16, 2.5851645773082386e-16, 2.5611634294614988e-16,
+    2.5371976244007951e-16, 2.5132649726057965e-16, 2.4893632659702241e-16,
+    2.4654902757768294e-16, 2.4416437505894113e-16, 2.4178214140547701e-16,
+    2.3940209626069293e-16, 2.3702400630653379e-16, 2.3464763501180906e-16,
+    2.3227274236804356e-16, 2.2989908461180176e-16, 2.2752641393233679e-16,
+    2.2515447816331335e-16, 2.2278302045723935e-16, 2.204117789411155e-16,
+    2.1804048635166997e-16, 2.1566886964838955e-16, 2.1329664960238282e-16,
+    2.1092354035891513e-16, 2.0854924897123756e-16, 2.0617347490308422e-16,
+    2.0379590949693867e-16, 2.0141623540485881e-16, 1.9903412597830126e-16,
+    1.9664924461299005e-16, 1.9426124404443025e-16, 1.918697655891598e-16,
+    1.8947443832625884e-16, 1.8707487821298241e-16, 1.8467068712763561e-16,
+    1.8226145183195804e-16, 1.7984674284430697e-16, 1.774261132138049e-16,
+    1.7499909718432348e-16, 1.7256520873568209e-16, 1.7012393998770629e-16,
+    1.6767475945078264e-16, 1.6521711010420062e-16, 1.627504072808351e-16,
+    1.6027403633350894e-16, 1.5778735005459566e-16, 1.5528966581595681e-16,
+    1.5278026239101634e-16, 1.5025837641447439e-16, 1.4772319842763569e-16,
+    1.4517386844829282e-16, 1.4260947099321272e-16, 1.4002902946807844e-16,
+    1.374314998236761e-16, 1.3481576335745427e-16, 1.3218061851538796e-16,
+    1.2952477151912267e-16, 1.2684682560606138e-16, 1.2414526862326372e-16,
+    1.2141845865694347e-16, 1.1866460730417874e-16, 1.1588176009705521e-16,
+    1.1306777346479322e-16, 1.102202874567018e-16, 1.0733669323436376e-16,
+    1.0441409405585334e-16, 1.0144925809006283e-16, 9.8438560874559134e-17,
+    9.5377914505292583e-17, 9.2262679629663583e-17, 8.9087554865647293e-17,
+    8.5846436168850365e-17, 8.2532235563518793e-17, 7.9136643961950929e-17,
+    7.5649815537392833e-17, 7.2059939574688914e-17, 6.835264680370038e-17,
+    6.4510165096727333e-17, 6.0510082606427474e-17, 5.6323471083954862e-17,
+    5.19119154462177e-17, 4.7222561556862579e-17, 4.2179302189289523e-17,
+    3.666569771447465e-17, 3.0487830247064049e-17, 2.3278824993382109e-17,
+    1.4178028487910376e-17,
+};
+
+static constexpr double ezig_f[257] = {
+    0.00016706669230796397, 0.00045413435384149698, 0.00096726928232717519,
+    0.0015362997803015741, 0.0021459677437189089, 0.0027887987935740783,
+    0.0034602647778369071, 0.0041572951208338005, 0.0048776559835424001,
+    0.0056196422072054934, 0.0063819059373191895, 0.0071633531836349977,
+    0.0079630774380170504, 0.0087803149858089839, 0.0096144136425022203,
+    0.010464810181029991, 0.011331013597834611, 0.0122125924262554,
+    0.013109164931255014, 0.014020391403181955, 0.014945968011691162,
+    0.01588562183997317, 0.016839106826039955, 0.017806200410911372,
+    0.018786700744696041, 0.019780424338009757, 0.020787204072578135,
+    0.021806887504283601, 0.022839335406385261, 0.023884420511558195,
+    0.024942026419731807, 0.026012046645134242, 0.027094383780955827,
+    0.028188948763978657, 0.029295660224637421, 0.030414443910466635,
+    0.031545232172893636, 0.032687963508959569, 0.033842582150874372,
+    0.035009037697397445, 0.036187284781931457, 0.037377282772959396,
+    0.038578995503074906, 0.039792391023374174, 0.041017441380414875,
+    0.042254122413316296, 0.043502413568888239, 0.044762297732943331,
+    0.046033761076175218, 0.047316792913181603, 0.048611385573379545,
+    0.049917534282706427, 0.051235237055126323, 0.052564494593071734,
+    0.053905310196046122, 0.055257689676697079, 0.056621641283742918,
+    0.057997175631200715, 0.059384305633420328, 0.060783046445479716,
+    0.062193415408541092, 0.063615431999807431, 0.06504911778675386,
+    0.066494496385339885, 0.067951593421936698, 0.069420436498728852,
+    0.07090105516237194, 0.072393480875708849, 0.073897746992364843,
+    0.075413888734058507, 0.076941943170480628, 0.078481949201606546,
+    0.080033947542320044, 0.081597980709237558, 0.083174093009632508,
+    0.084762330532368257, 0.086362741140757038, 0.087975374467270356,
+    0.089600281910032997, 0.09123751663104028, 0.092887133556043652,
+    0.094549189376055956, 0.096223742550432909, 0.097910853311492296,
+    0.099610583670637229, 0.10132299742595373, 0.1030481601712578,
+    0.10478613930657024, 0.10653700405000172, 0.10830082545103385,
+    0.11007767640518545, 0.11186763167005638, 0.11367076788274438,
+    0.1154871635786336, 0.11731689921155564, 0.11916005717532775,
+    0.1210167218266749, 0.12288697950954522, 0.12477091858083104,
+    0.12666862943751078, 0.12858020454522831, 0.13050573846833088,
+    0.13244532790138763, 0.13439907170221371, 0.13636707092642894,
+    0.13834942886358029, 0.14034625107486251, 0.14235764543247223,
+    0.1443837221606348, 0.14642459387834497, 0.14848037564386682,
+    0.15055118500103992, 0.15263714202744288, 0.15473836938446811,
+    0.15685499236936526, 0.15898713896931421, 0.16113493991759203,
+    0.16329852875190184, 0.16547804187493603, 0.16767361861725019,
+    0.16988540130252766, 0.17211353531532003, 0.17435816917135349,
+    0.17661945459049491, 0.17889754657247833, 0.18119260347549629,
+    0.18350478709776746, 0.18583426276219714, 0.18818119940425432,
+    0.19054576966319539, 0.19292814997677132, 0.19532852067956319,
+    0.19774706610509882, 0.20018397469191121, 0.20263943909370896,
+    0.20511365629383765, 0.20760682772422198, 0.21011915938898823,
+    0.21265086199297822, 0.21520215107537863, 0.21777324714870047,
+    0.22036437584335944, 0.22297576805812011, 0.22560766011668396,
+    0.22826029393071662, 0.23093391716962736, 0.23362878343743329,
+    0.23634515245705956, 0.23908329026244909, 0.24184346939887713,
+    0.24462596913189202, 0.24743107566532754, 0.25025908236886224,
+    0.2531102900156294, 0.25598500703041532, 0.25888354974901617,
+    0.26180624268936292, 0.26475341883506215, 0.26772541993204474,
+    0.27072259679905997, 0.27374530965280292, 0.2767939284485173,
+    0.27986883323697287, 0.28297041453878075, 0.28609907373707683,
+    0.28925522348967769, 0.29243928816189263, 0.29565170428126125,
+    0.29889292101558185, 0.30216340067569353, 0.30546361924459026,
+    0.30879406693456019, 0.31215524877417961, 0.31554768522712895,
+    0.31897191284495724, 0.32242848495608922, 0.32591797239355635,
+    0.32944096426413644, 0.3329980687618091, 0.33658991402867772,
+    0.34021714906678019, 0.34388044470450257, 0.34758049462163715,
+    0.35131801643748345, 0.35509375286678763, 0.35890847294875,
+    0.362762973354818, 0.36665807978151438, 0.37059464843514622,
+    0.37457356761590238, 0.37859575940958107, 0.38266218149601006,
+    0.38677382908413793, 0.39093173698479738, 0.39513698183329043,
+    0.39939068447523135, 0.40369401253053055, 0.40804818315203267,
+    0.41245446599716146, 0.41691418643300321, 0.42142872899761691,
+    0.42599954114303468, 0.43062813728845917, 0.43531610321563691,
+    0.44006510084235417, 0.44487687341454885, 0.44975325116275533,
+    0.45469615747461584, 0.45970761564213802, 0.46478975625042651,
+    0.46994482528396031, 0.47517519303737771, 0.48048336393045454,
+    0.48587198734188525, 0.49134386959403287, 0.49690198724154988,
+    0.50254950184134806, 0.50828977641064321, 0.51412639381474889,
+    0.52006317736823393, 0.52610421398362006, 0.53225388026304365,
+    0.53851687200286225, 0.54489823767244006, 0.55140341654064173,
+    0.55803828226258789, 0.56480919291240061, 0.57172304866482615,
+    0.57878735860284536, 0.58601031847726837, 0.59340090169173376,
+    0.60096896636523256, 0.60872538207962235, 0.61668218091520788,
+    0.6248527387036662, 0.6332519942143664, 0.64189671642726642,
+    0.65080583341457143, 0.66000084107900014, 0.66950631673192518,
+    0.67935057226476581, 0.68956649611707843, 0.70019265508278861,
+    0.71127476080507646, 0.72286765959357246, 0.73503809243142404,
+    0.74786862198519566, 0.76146338884989684, 0.77595685204011622,
+    0.79152763697249628, 0.80842165152300904, 0.8269932966430511,
+    0.8477855006239905, 0.87170433238120471, 0.90046992992574781,
+    0.93814368086217659, 1,
+};
+
+/* exponential ziggurat, also from Marsaglia & Tsang.  same as zig_normal()
+ * but one-sided, and the tail beyond ezig_r is itself exponential, so it
+ * only needs one more uniform and a log
+ */
+template<typename BS, typename T, typename G = gen_dynamic<BS>>
+static double zig_exponential(BS *bs)
+{
+    constexpr unsigned pos_bits = mantissa_bits<T>;
 
-            randfv(bs, u, 2, 0.0, 1.0);
+    for (;;) {
+        const uint64_t r = bs_bits<BS, G>(bs, 8 + pos_bits);
+        const unsigned i = r & 0xff;
+        const uint64_t pos = (r >> 8) << (52 - pos_bits);
+        const double x = pos * ezig_w[i];
+        T u;
 
-            v[0] = randutil_fma(2.0, u[0], -1.0);
-            v[1] = randutil_fma(2.0, u[1], -1.0);
-            s = v[0] * v[0] + v[1] * v[1];
-        } while (s >= 1.0 || s == 0.0);
+        if (pos < ezig_k[i])
+            return x;
 
-        t = randutil_sqrt(-2.0 * randutil_log(s) / s);
-        x = v[0] * t;
+        randfv<BS, T, G>(bs, &u, 1, 0.0, 1.0);
+
+        if (i == 0) {
+            if (u > 0)
+                return ezig_r - randutil_log(u);
+        }
+        else if (randutil_fma(u, ezig_f[i + 1] - ezig_f[i], ezig_f[i])
+                 < randutil_exp(-x)) {
+            return x;
+        }
+    }
+}
+
+template<typename BS, typename T, typename G = gen_dynamic<BS>>
+static void exponentialv(BS *bs, T *out, std::size_t count, double mean)
+{
+    std::size_t i;
+
+    for (i = 0; i < count; i++) {
+        out[i] = mean * zig_exponential<BS, T, G>(bs);
+    }
+}
+
+/* floor(x) as a T, for x >= 0, saturating at T's max */
+template<typename T>
+static inline T sat_floor(double x)
+{
+    constexpr T max = std::numeric_limits<T>::max();
+
+    return x >= static_cast<double>(max) ? max : static_cast<T>(x);
+}
+
+template<typename BS, typename G = gen_dynamic<BS>>
+static inline double bs_unit(BS *bs)
+{
+    double u;
+
+    randfv<BS, double, G>(bs, &u, 1, 0.0, 1.0);
+    return u;
+}
+
+/* log(k!), for the Poisson acceptance test.  exact below 10, then by the
+ * Stirling series, which is good to about 1e-12 from there
+ */
+static double log_factorial(double k)
+{
+    static constexpr double small[10] = {
+        0, 0, 0.69314718055994495,
+        1.7917594692280554, 3.1780538303479449, 4.7874917427820467,
+        6.5792512120101021, 8.5251613610654147, 10.604602902745249,
+        12.801827480081467,
+    };
+    const double x = k + 1.0, x2 = 1.0 / (x * x);
+
+    if (k < 10.0)
+        return small[static_cast<unsigned>(k)];
+
+    return (x - 0.5) * randutil_log(x) - x + 0.91893853320467274
+           + (1.0 / 12.0 - x2 * (1.0 / 360.0 - x2 * (1.0 / 1260.0
+                                                      - x2 / 1680.0))) / x;
+}
+
+/* Poisson deviates.  small means use inversion by sequential search, which
+ * takes about mean + 1 steps.  larger means use Hörmann's PTRS, "The
+ * transformed rejection method for generating Poisson random variables"
+ * (1993), which needs two uniforms and almost never the log-gamma test
+ */
+template<typename BS, typename T, typename G = gen_dynamic<BS>>
+static void poissonv(BS *bs, T *out, std::size_t count, double mean)
+{
+    std::size_t i;
+
+    hard_assert(mean >= 0.0);
+
+    if (mean < 10.0) {
+        const double p0 = randutil_exp(-mean);
+
+        for (i = 0; i < count; i++) {
+            double u = bs_unit<BS, G>(bs), p = p0;
+            T k = 0;
+
+            /* subtracting rather than accumulating the cdf keeps u > p
+             * from looping on rounding error: p underflows eventually
+             */
+            while (u > p && p > 0.0) {
+                u -= p;
+                k++;
+                p *= mean / k;
+            }
+
+            out[i] = k;
+        }
+        return;
+    }
+
+    const double smu = randutil_sqrt(mean);
+    const double log_mean = randutil_log(mean);
+    const double b = randutil_fma(2.53, smu, 0.931);
+    const double a = randutil_fma(0.02483, b, -0.059);
+    const double log_inv_alpha = randutil_log(1.1239 + 1.1328 / (b - 3.4));
+    const double vr = 0.9277 - 3.6224 / (b - 2.0);
+
+    for (i = 0; i < count; i++) {
+        for (;;) {
+            const double u = bs_unit<BS, G>(bs) - 0.5;
+            const double v = bs_unit<BS, G>(bs);
+            const double us = 0.5 - (u < 0.0 ? -u : u);
+            double x, k;
+
+            if (us == 0.0) continue;
+
+            x = (2.0 * a / us + b) * u + mean + 0.43;
+            if (x < 0.0) continue;
+
+            out[i] = sat_floor<T>(x);
+            if (us >= 0.07 && v <= vr) break;
+            if (us < 0.013 && v > us) continue;
+
+            k = static_cast<double>(out[i]);
+            if (randutil_log(v) + log_inv_alpha
+                - randutil_log(a / (us * us) + b)
+                <= k * log_mean - mean - log_factorial(k))
+                break;
+        }
+    }
+}
+
+/* binomial deviates, by Kachitvichyanukul & Schmeiser's BTPE, "Binomial
+ * random variate generation" (1988), for n * min(p, 1 - p) >= 30, and by
+ * inversion (their BINV) below that.  both work with r = min(p, 1 - p),
+ * and count failures instead of successes when p > 0.5
+ */
+template<typename BS, typename T, typename G = gen_dynamic<BS>>
+static void binomialv(BS *bs, T *out, std::size_t count, T n, double p)
+{
+    const double r = p <= 0.5 ? p : 1.0 - p;
+    const double q = 1.0 - r;
+    const double dn = static_cast<double>(n);
+    const double nr = dn * r;
+    std::size_t i;
+
+    hard_assert(p >= 0.0 && p <= 1.0);
+
+    if (nr < 30.0) {
+        const double qn = randutil_exp(dn * randutil_log1p(-r));
+        const double bound = std::min(dn, nr + 10.0 * randutil_sqrt(nr * q
+                                                                    + 1.0));
+
+        for (i = 0; i < count; i++) {
+            double u = bs_unit<BS, G>(bs), px = qn;
+            T x = 0;
+
+            while (u > px) {
+                x++;
+                if (x > bound) {
+                    x = 0;
+                    px = qn;
+                    u = bs_unit<BS, G>(bs);
+                }
+                else {
+                    u -= px;
+                    px = (dn - x + 1.0) * r * px / (x * q);
+                }
+            }
+
+            out[i] = p > 0.5 ? n - x : x;
+        }
+        return;
+    }
+
+    const double fm = nr + r;
+    const double m = static_cast<double>(sat_floor<T>(fm));
+    const double nrq = nr * q;
+    const double p1 = static_cast<double>(
+        sat_floor<T>(2.195 * randutil_sqrt(nrq) - 4.6 * q)) + 0.5;
+    const double xm = m + 0.5;
+    const double xl = xm - p1;
+    const double xr = xm + p1;
+    const double c = 0.134 + 20.5 / (15.3 + m);
+    const double al = (fm - xl) / (fm - xl * r);
+    const double lam_l = al * (1.0 + 0.5 * al);
+    const double ar = (xr - fm) / (xr * q);
+    const double lam_r = ar * (1.0 + 0.5 * ar);
+    const double p2 = p1 * (1.0 + 2.0 * c);
+    const double p3 = p2 + c / lam_l;
+    const double p4 = p3 + c / lam_r;
+
+    for (i = 0; i < count; i++) {
+        double y;
+
+        for (;;) {
+            const double u = bs_unit<BS, G>(bs) * p4;
+            double v = bs_unit<BS, G>(bs);
+            double k;
+
+            if (u <= p1) {
+                /* triangular region: always accepted */
+                y = static_cast<double>(sat_floor<T>(xm - p1 * v + u));
+                break;
+            }
+            else if (u <= p2) {
+                /* parallelograms */
+                const double x = xl + (u - p1) / c;
+
+                v = v * c + 1.0 - (m - x + 0.5 < 0.0 ? x - m - 0.5
+                                                     : m - x + 0.5) / p1;
+                if (v > 1.0 || x < 0.0) continue;
+                y = static_cast<double>(sat_floor<T>(x));
+            }
+            else if (u <= p3) {
+                /* left exponential tail */
+                const double x = xl + randutil_log(v) / lam_l;
+
+                if (x < 0.0 || v == 0.0) continue;
+                y = static_cast<double>(sat_floor<T>(x));
+                v = v * (u - p2) * lam_l;
+            }
+            else {
+                /* right exponential tail */
+                y = static_cast<double>(
+                    sat_floor<T>(xr - randutil_log(v) / lam_r));
+                if (y > dn || v == 0.0) continue;
+                v = v * (u - p3) * lam_r;
+            }
+
+            k = y < m ? m - y : y - m;
+            if (k <= 20.0 || k >= 0.5 * nrq - 1.0) {
+                /* explicit evaluation of f(y) / f(m) */
+                const double s = r / q;
+                const double sa = s * (dn + 1.0);
+                double f = 1.0, j;
+
+                if (m < y) {
+                    for (j = m + 1.0; j <= y; j++)
+                        f *= sa / j - s;
+                }
+                else if (m > y) {
+                    for (j = y + 1.0; j <= m; j++)
+                        f /= sa / j - s;
+                }
+
+                if (v <= f) break;
+                continue;
+            }
+
+            /* squeeze on log(f(y) / f(m)), then the Stirling bound */
+            const double rho = (k / nrq)
+                               * ((k * (k / 3.0 + 0.625) + 1.0 / 6.0) / nrq
+                                  + 0.5);
+            const double t = -k * k / (2.0 * nrq);
+            const double la = randutil_log(v);
+
+            if (la < t - rho) break;
+            if (la > t + rho) continue;
+
+            const double x1 = y + 1.0, f1 = m + 1.0;
+            const double z = dn + 1.0 - m, w = dn - y + 1.0;
+            const double x2 = x1 * x1, f2 = f1 * f1;
+            const double z2 = z * z, w2 = w * w;
+            const auto stirling = [](double a1, double a2) {
+                return (13680.0 - (462.0 - (132.0 - (99.0 - 140.0 / a2)
+                                                    / a2) / a2) / a2)
+                       / a1 / 166320.0;
+            };
+
+            if (la <= xm * randutil_log(f1 / x1)
+                      + (dn - m + 0.5) * randutil_log(z / w)
+                      + (y - m) * randutil_log(w * r / (x1 * q))
+                      + stirling(f1, f2) + stirling(z, z2)
+                      + stirling(x1, x2) + stirling(w, w2))
+                break;
+        }
+
+        out[i] = p > 0.5 ? n - static_cast<T>(y) : static_cast<T>(y);
+    }
+}
+
+/* geometric deviates: the number of failures before the first success,
+ * with success probability p.  that's floor(E / -log(1 - p)) for standard
+ * exponential E, which the ziggurat makes cheaper than inverting directly
+ */
+template<typename BS, typename T, typename G = gen_dynamic<BS>>
+static void geometricv(BS *bs, T *out, std::size_t count, double p)
+{
+    std::size_t i;
+
+    hard_assert(p > 0.0 && p <= 1.0);
+
+    if (p == 1.0) {
+        for (i = 0; i < count; i++)
+            out[i] = 0;
+        return;
+    }
+
+    const double scale = -1.0 / randutil_log1p(-p);
+
+    for (i = 0; i < count; i++) {
+        out[i] = sat_floor<T>(scale * zig_exponential<BS, double, G>(bs));
+    }
+}
+
+/* Zipf deviates: k in [1, n] with probability proportional to k^-s, by
+ * Hörmann & Derflinger's rejection-inversion, "Rejection-inversion to
+ * generate variates from monotone discrete distributions" (1996), in the
+ * form used by Apache Commons RNG.  it inverts the integral of the hat
+ * function h(x) = x^-s, so it needs no tables and takes O(1) time for any
+ * n, with about 1.1 iterations on average
+ */
+static inline double zipf_log1p_x(double x)
+{
+    /* log1p(x) / x */
+    if (x > 1e-8 || x < -1e-8)
+        return randutil_log1p(x) / x;
+    return 1.0 - x * (0.5 - x * (1.0 / 3.0 - 0.25 * x));
+}
+
+static inline double zipf_expm1_x(double x)
+{
+    /* expm1(x) / x */
+    if (x > 1e-8 || x < -1e-8)
+        return randutil_expm1(x) / x;
+    return 1.0 + x * 0.5 * (1.0 + x * (1.0 / 3.0) * (1.0 + 0.25 * x));
+}
+
+static inline double zipf_h(double x, double s)
+{
+    return randutil_exp(-s * randutil_log(x));
+}
+
+static inline double zipf_h_integral(double x, double s)
+{
+    const double lx = randutil_log(x);
+
+    return zipf_expm1_x((1.0 - s) * lx) * lx;
+}
+
+static inline double zipf_h_integral_inv(double x, double s)
+{
+    double t = x * (1.0 - s);
+
+    if (t < -1.0) t = -1.0;
+    return randutil_exp(zipf_log1p_x(t) * x);
+}
+
+template<typename BS, typename T, typename G = gen_dynamic<BS>>
+static void zipfv(BS *bs, T *out, std::size_t count, T n, double s)
+{
+    std::size_t i;
+
+    hard_assert(n > 0);
+    hard_assert(s >= 0.0);
+
+    const double dn = static_cast<double>(n);
+    const double h_x1 = zipf_h_integral(1.5, s) - 1.0;
+    const double h_n = zipf_h_integral(dn + 0.5, s);
+    const double squeeze = 2.0 - zipf_h_integral_inv(zipf_h_integral(2.5, s)
+                                                     - zipf_h(2.0, s), s);
+
+    for (i = 0; i < count; i++) {
+        for (;;) {
+            const double u = randutil_fma(bs_unit<BS, G>(bs), h_x1 - h_n, h_n);
+            const double x = zipf_h_integral_inv(u, s);
+            T k = sat_floor<T>(x + 0.5);
+            double dk;
+
+            if (k < 1) k = 1;
+            if (k > n) k = n;
+            dk = static_cast<double>(k);
+
+            if (dk - x <= squeeze
+                || u >= zipf_h_integral(dk + 0.5, s) - zipf_h(dk, s)) {
+                out[i] = k;
+                break;
+            }
+        }
+    }
+}
+
+/* Bernoulli(p) bits, 64 lanes per word.  a lane's bit is U < p for a
+ * uniform U whose binary digits are drawn one per word, most significant
+ * first: at the first digit where U and p differ, U < p if p's digit is
+ * the 1.  each word drawn settles about half of the undecided lanes, and
+ * once p has no 1 digits left the undecided lanes have U >= p.  the
+ * digit-dependent update is done with masks, as it would otherwise
+ * mispredict for most p
+ */
+template<typename BS, typename G = gen_dynamic<BS>>
+static void bernoulli_mask(BS *bs, uint64_t *mask, std::size_t n_bits,
+                           double p)
+{
+    const std::size_t n_words = (n_bits + 63) / 64;
+    uint64_t threshold;
+    std::size_t i;
+
+    hard_assert(p >= 0.0 && p <= 1.0);
+
+    if (p == 1.0) {
+        for (i = 0; i < n_words; i++)
+            mask[i] = UINT64_MAX;
     }
     else {
-        x = v[1] * t;
+        threshold = static_cast<uint64_t>(p * 0x1p64);
+
+        for (i = 0; i < n_words; i++) {
+            uint64_t result = 0, undecided = UINT64_MAX, digits = threshold;
+
+            while (undecided && digits) {
+                const uint64_t r = bs_next64<BS, G>(bs);
+                const uint64_t one = UINT64_C(0) - (digits >> 63);
+
+                result |= undecided & ~r & one;
+                undecided &= r ^ ~one;
+                digits <<= 1;
+            }
+
+            mask[i] = result;
+        }
+    }
+
+    if (n_bits % 64)
+        mask[n_words - 1] &= mask_bits(n_bits % 64);
+}
+
+/* probability threshold / 2^32 of keeping a column's own index, where the
+ * column's scaled weight is less than the (scaled) average, sum */
+static inline uint32_t alias_threshold(double scaled, double sum)
+{
+    const double t = scaled / sum * 0x1p32;
+
+    return t < 0x1p32 ? (uint32_t) t : UINT32_MAX;
+}
+
+static inline uint32_t alias_threshold(unsigned __int128 scaled,
+                                       unsigned __int128 sum)
+{
+    /* scaled < sum <= 2^32 * 2^64, so this doesn't overflow */
+    return (scaled << 32) / sum;
+}
+
+/* Vose, "A linear algorithm for generating random numbers with a given
+ * distribution", with weights scaled by n_elems rather than normalised, so
+ * that integer weights are exact.  S is wide enough to hold the scaled
+ * weights and their sum
+ */
+template<typename W, typename S>
+static int alias_build(struct alias_table *at,
+                       const void *base, size_t n_elems, size_t elem_size,
+                       size_t weight_offset)
+{
+    const unsigned char *data = static_cast<const unsigned char *>(base);
+    struct alias_entry *entries;
+    S *scaled, sum = 0;
+    uint32_t *work;
+    size_t i, n_small = 0, n_large = 0;
+
+    hard_assert(n_elems > 0 && n_elems <= UINT32_MAX);
+    hard_assert(elem_size >= sizeof(W));
+
+    entries = static_cast<struct alias_entry *>(
+        randutil_malloc(n_elems * sizeof(entries[0])));
+    scaled = static_cast<S *>(randutil_malloc(n_elems * sizeof(scaled[0])));
+    work = static_cast<uint32_t *>(randutil_malloc(n_elems * sizeof(work[0])));
+
+    if (MALLOC_FAILED(!entries || !scaled || !work)) {
+        randutil_free(work);
+        randutil_free(scaled);
+        randutil_free(entries);
+        return -1;
+    }
+
+    for (i = 0; i < n_elems; i++) {
+        W w;
+
+        __builtin_memcpy(&w, data + i * elem_size + weight_offset, sizeof(w));
+        if constexpr (std::is_floating_point_v<W>)
+            hard_assert(w >= 0 && w <= std::numeric_limits<W>::max());
+
+        scaled[i] = static_cast<S>(w) * n_elems;
+        sum += w;
+    }
+    hard_assert(sum > 0);
+    if constexpr (std::is_floating_point_v<S>)
+        hard_assert(sum <= std::numeric_limits<S>::max() / n_elems);
+
+    /* small columns are stacked from the front of work, large ones from
+     * the back.  each column is on at most one stack, so they never meet
+     */
+    for (i = 0; i < n_elems; i++) {
+        if (scaled[i] < sum)
+            work[n_small++] = i;
+        else
+            work[n_elems - ++n_large] = i;
+    }
+
+    /* fill each small column up to the average from a large one */
+    while (n_small && n_large) {
+        const uint32_t s = work[--n_small];
+        const uint32_t l = work[n_elems - n_large];
+
+        entries[s].threshold = alias_threshold(scaled[s], sum);
+        entries[s].alias = l;
+
+        scaled[l] = (scaled[l] + scaled[s]) - sum;
+        if (scaled[l] < sum) {
+            n_large--;
+            work[n_small++] = l;
+        }
+    }
+
+    /* whatever's left is full, give or take floating point error */
+    while (n_small) {
+        const uint32_t s = work[--n_small];
+
+        entries[s] = (struct alias_entry){ UINT32_MAX, s };
+    }
+    while (n_large) {
+        const uint32_t l = work[n_elems - n_large--];
+
+        entries[l] = (struct alias_entry){ UINT32_MAX, l };
+    }
+
+    randutil_free(work);
+    randutil_free(scaled);
+
+    at->n_elems = n_elems;
+    at->entries = entries;
+    return 0;
+}
+
+template<typename BS, typename G = gen_dynamic<BS>>
+static void alias_samplev(BS *bs, const struct alias_table *at,
+                          unsigned *out, std::size_t count)
+{
+    std::size_t i;
+
+    for (i = 0; i < count; i++) {
+        const uint32_t col = bs_below<BS, G>(bs, at->n_elems);
+        const struct alias_entry e = at->entries[col];
+
+        out[i] = bs_bits<BS, G>(bs, 32) < e.threshold ? col : e.alias;
+    }
+}
+
+/* parallel fills: each segment gets a fresh philox substream, read a whole
+ * block at a time rather than recomputing the block for every word the way
+ * philox4x32_next() must.  the words are the same either way, so a
+ * segment's values match what a randbs positioned at its substream would
+ * produce
+ */
+struct philox_bs : randbs {
+    uint32_t block[4];
+    unsigned n_block;
+};
+
+template<>
+constexpr unsigned rng_bits<philox_bs> = 32;
+
+struct gen_philox4x32_block {
+    static inline uint32_t next(philox_bs *bs)
+    {
+        if (!bs->n_block) {
+            const uint64_t w = bs->state.s[0]
+                               | (uint64_t) bs->state.s[1] << 32;
+            const uint32_t key[2] = { bs->state.s[2], bs->state.s[3] };
+
+            bs->block[0] = (uint32_t) (w >> 2);
+            bs->block[1] = (uint32_t) (w >> 34);
+            bs->block[2] = bs->block[3] = 0;
+            philox4x32_10(bs->block, key);
+
+            bs->n_block = 4 - (w & 3);
+            bs->state.s[0] = (uint32_t) (w + bs->n_block);
+            bs->state.s[1] = (uint32_t) ((w + bs->n_block) >> 32);
+        }
+
+        return bs->block[4 - bs->n_block--];
+    }
+};
+
+enum class fill_kind { RANDIV, RANDFV, GAUSSV };
+
+template<typename T>
+struct fill_job {
+    const struct randbs *bs;
+    T *out;
+    std::size_t count;
+    T min, max;
+    double a, b;
+};
+
+template<typename T, fill_kind K>
+static void fill_chunk(void *arg, unsigned chunk [[maybe_unused]],
+                       std::size_t begin, std::size_t end)
+{
+    const fill_job<T> *job = static_cast<const fill_job<T> *>(arg);
+    const uint64_t w0 = job->bs->state.s[0]
+                        | (uint64_t) job->bs->state.s[1] << 32;
+    philox_bs bs;
+    std::size_t s;
+
+    static_cast<struct randbs &>(bs) = *job->bs;
+
+    for (s = begin; s < end; s++) {
+        const uint64_t w = w0 + s * RANDBS_PARALLEL_STRIDE;
+        const std::size_t i = s * RANDBS_PARALLEL_SEGMENT;
+        const std::size_t n = std::min<std::size_t>(job->count - i,
+                                                    RANDBS_PARALLEL_SEGMENT);
+
+        bs.state.s[0] = (uint32_t) w;
+        bs.state.s[1] = (uint32_t) (w >> 32);
+        bs.bits = bs.n_bits = 0;
+        bs.has_gauss_spare = false;
+        bs.n_block = 0;
+
+        if constexpr (K == fill_kind::RANDIV)
+            randiv<philox_bs, T, gen_philox4x32_block>(&bs, &job->out[i], n,
+                                                       job->min, job->max);
+        else if constexpr (K == fill_kind::RANDFV)
+            randfv<philox_bs, T, gen_philox4x32_block>(&bs, &job->out[i], n,
+                                                       job->a, job->b);
+        else
+            gaussv<philox_bs, T, gen_philox4x32_block>(&bs, &job->out[i], n,
+                                                       job->a, job->b);
+    }
+}
+
+template<typename T, fill_kind K>
+static void fill_parallel(const struct randbs *bs, T *out, std::size_t count,
+                          T min, T max, double a, double b,
+                          unsigned n_threads)
+{
+    const std::size_t n_segments = (count + RANDBS_PARALLEL_SEGMENT - 1)
+                                   / RANDBS_PARALLEL_SEGMENT;
+    fill_job<T> job = { bs, out, count, min, max, a, b };
+
+    hard_assert(bs->func == philox4x32_next);
+
+    parallel_for(n_threads, n_segments, 1, &fill_chunk<T, K>, &job);
+}
+
+/* shuffle element access.  fixed sizes are swapped with constant-size
+ * copies, which compile to plain loads and stores; other sizes are swapped
+ * a cache line at a time through a stack buffer
+ */
+template<std::size_t N>
+struct elems_fixed {
+    unsigned char *base;
+
+    inline unsigned char *addr(std::size_t i) const { return base + i * N; }
+    inline elems_fixed at(std::size_t i) const { return { addr(i) }; }
+
+    inline void swap(std::size_t i, std::size_t j) const
+    {
+        unsigned char a[N], b[N];
+
+        __builtin_memcpy(a, addr(i), N);
+        __builtin_memcpy(b, addr(j), N);
+        __builtin_memcpy(addr(i), b, N);
+        __builtin_memcpy(addr(j), a, N);
+    }
+
+    /* swap if c, without branching on it */
+    inline void cswap(std::size_t i, std::size_t j, bool c) const
+    {
+        using W = std::conditional_t<N % 8 == 0, uint64_t, uint32_t>;
+        constexpr std::size_t n = N / sizeof(W);
+        W a[n], b[n];
+        std::size_t k;
+
+        __builtin_memcpy(a, addr(i), N);
+        __builtin_memcpy(b, addr(j), N);
+        for (k = 0; k < n; k++) {
+            const W m = -(W) c & (a[k] ^ b[k]);
+
+            a[k] ^= m;
+            b[k] ^= m;
+        }
+        __builtin_memcpy(addr(i), a, N);
+        __builtin_memcpy(addr(j), b, N);
+    }
+};
+
+struct elems_var {
+    unsigned char *base;
+    std::size_t size;
+
+    inline unsigned char *addr(std::size_t i) const { return base + i * size; }
+    inline elems_var at(std::size_t i) const { return { addr(i), size }; }
+
+    void swap(std::size_t i, std::size_t j) const
+    {
+        unsigned char *p = addr(i), *q = addr(j);
+        unsigned char t[64];
+        std::size_t off, n;
+
+        if (i == j) return;
+
+        for (off = 0; off < size; off += n) {
+            n = std::min(sizeof(t), size - off);
+
+            __builtin_memcpy(t, p + off, n);
+            __builtin_memcpy(p + off, q + off, n);
+            __builtin_memcpy(q + off, t, n);
+        }
+    }
+
+    inline void cswap(std::size_t i, std::size_t j, bool c) const
+    {
+        if (c) swap(i, j);
+    }
+};
+
+template<typename F>
+static void with_elems(void *base, std::size_t elem_size, F &&f)
+{
+    unsigned char *p = static_cast<unsigned char *>(base);
+
+    switch (elem_size) {
+    case 4:  f(elems_fixed<4>{ p });           break;
+    case 8:  f(elems_fixed<8>{ p });           break;
+    case 16: f(elems_fixed<16>{ p });          break;
+    default: f(elems_var{ p, elem_size });     break;
+    }
+}
+
+/* Fisher-Yates over [0, n).  the random indices don't depend on the
+ * array, so they're drawn a batch at a time and their elements prefetched
+ * before swapping, to overlap the cache misses of large arrays
+ */
+#define SHUFFLE_BATCH (64U)
+
+/* blocks for shuffle_parallel(): about a large L2's worth */
+#define SHUFFLE_BLOCK_BYTES (1024U * 1024U)
+
+template<typename BS, typename G, typename E>
+static void shuffle_fy(BS *bs, const E e, std::size_t n)
+{
+    std::size_t idx[SHUFFLE_BATCH];
+    std::size_t i, k, m;
+
+    if (n < 2) return;
+
+    for (i = 0; i < n - 1; i += m) {
+        m = std::min<std::size_t>(SHUFFLE_BATCH, n - 1 - i);
+
+        for (k = 0; k < m; k++) {
+            idx[k] = i + k + bs_below<BS, G>(bs, n - i - k);
+            __builtin_prefetch(e.addr(idx[k]), 1);
+        }
+
+        for (k = 0; k < m; k++)
+            e.swap(i + k, idx[k]);
+    }
+}
+
+/* MergeShuffle's merge (Bacher et al., https://arxiv.org/abs/1508.03167):
+ * [start, mid) and [mid, end) are each uniformly shuffled; interleave them
+ * by coin flips until one side runs out, then insert the rest of the other
+ * side at uniformly random positions.  the result is a uniform shuffle of
+ * [start, end), and apart from the final inserts, accesses are sequential
+ */
+template<typename BS, typename G, typename E>
+static void shuffle_merge(BS *bs, const E e,
+                          std::size_t start, std::size_t mid, std::size_t end)
+{
+    std::size_t i = start, j = mid;
+    uint64_t coins = 0;
+    unsigned n_coins = 0;
+
+    /* coins are unpredictable, so nothing branches on them: the exit test
+     * is bitwise, and the swap is conditional.  the loop only exits when
+     * the coin picks an exhausted side, so while j == end the coin is 0
+     * and i stands in for j
+     */
+    for (;; i++) {
+        bool c;
+
+        if (!n_coins) {
+            coins = bs_bits<BS, G>(bs, 64);
+            n_coins = 64;
+        }
+        c = coins & 1;
+        coins >>= 1;
+        n_coins--;
+
+        if (((unsigned) c & (j == end)) | ((unsigned) !c & (i == j)))
+            break;
+
+        e.cswap(i, j < end ? j : i, c);
+        j += c;
     }
 
-    phase = 1 - phase;
+    for (; i < end; i++)
+        e.swap(i, start + bs_below<BS, G>(bs, i - start + 1));
+}
 
-    return randutil_fma(stddev, x, mean);
+/* blocked shuffle: each block is shuffled by Fisher-Yates, then pairs of
+ * neighbouring runs are merged, doubling the run length each level.  every
+ * task (a block shuffle or a merge) draws from its own philox stream,
+ * keyed by the level and task index relative to a key drawn from the
+ * caller's stream, so the result doesn't depend on the number of threads
+ */
+struct shuffle_job {
+    void *base;
+    std::size_t n_elems;
+    std::size_t elem_size;
+    std::size_t block;
+    uint64_t key;
+    unsigned level;
+};
+
+static void shuffle_task_bs(philox_bs *bs, uint64_t key,
+                            unsigned level, std::size_t task)
+{
+    __builtin_memset(bs, 0, sizeof(*bs));
+    bs->func = philox4x32_next;
+    philox4x32_state(&bs->state, key + ((uint64_t) level << 40) + task, 0);
+}
+
+static void shuffle_level_chunk(void *arg, unsigned chunk [[maybe_unused]],
+                                std::size_t begin, std::size_t end)
+{
+    const shuffle_job *job = static_cast<const shuffle_job *>(arg);
+    const std::size_t run = job->block << (job->level ? job->level - 1 : 0);
+
+    with_elems(job->base, job->elem_size, [&](const auto &e) {
+        philox_bs bs;
+        std::size_t t;
+
+        for (t = begin; t < end; t++) {
+            shuffle_task_bs(&bs, job->key, job->level, t);
+
+            if (job->level == 0) {
+                const std::size_t lo = t * job->block;
+                const std::size_t n = std::min(job->block,
+                                               job->n_elems - lo);
+                shuffle_fy<philox_bs, gen_philox4x32_block>(&bs, e.at(lo), n);
+            }
+            else {
+                const std::size_t lo = 2 * t * run;
+                const std::size_t mid = lo + run;
+                const std::size_t hi = std::min(mid + run, job->n_elems);
+
+                if (mid < hi)
+                    shuffle_merge<philox_bs, gen_philox4x32_block>(&bs, e,
+                                                                   lo, mid,
+                                                                   hi);
+            }
+        }
+    });
 }
 
 extern "C" {
 
+void bernoulli_mask(struct randbs *bs,
+                    uint64_t *mask,
+                    size_t n_bits,
+                    double p_true)
+{
+    bernoulli_mask<struct randbs>(bs, mask, n_bits, p_true);
+}
+
 uint64_t randbs_bits(struct randbs *bs, unsigned want_bits)
 {
     return bs_bits(bs, want_bits);
@@ -267,6 +1832,42 @@ unsigned randbs_zeroes(struct randbs *bs, unsigned limit)
     return bs_zeroes(bs, limit);
 }
 
+int alias_init_u64(struct alias_table *at,
+                   const void *base, size_t n_elems, size_t elem_size,
+                   size_t weight_offset)
+{
+    return alias_build<uint64_t, unsigned __int128>(at, base, n_elems,
+                                                    elem_size, weight_offset);
+}
+
+int alias_init_f64(struct alias_table *at,
+                   const void *base, size_t n_elems, size_t elem_size,
+                   size_t weight_offset)
+{
+    return alias_build<double, double>(at, base, n_elems,
+                                       elem_size, weight_offset);
+}
+
+void alias_samplev(struct randbs *bs, const struct alias_table *at,
+                   unsigned *out, size_t count)
+{
+    alias_samplev<struct randbs>(bs, at, out, count);
+}
+
+uint32_t randbs_below32(struct randbs *bs, uint32_t bound)
+{
+    hard_assert(bound > 0);
+
+    return bs_below(bs, bound);
+}
+
+uint64_t randbs_below64(struct randbs *bs, uint64_t bound)
+{
+    hard_assert(bound > 0);
+
+    return bs_below(bs, bound);
+}
+
 void randi8v(struct randbs *bs,
              int8_t *out,
              size_t count,
@@ -385,7 +1986,108 @@ double gaussf64(struct randbs *bs, double mean, double stddev)
     return gauss<struct randbs, double>(bs, mean, stddev);
 }
 
-#if 0
+void exponentialf32v(struct randbs *bs,
+                     float *out,
+                     size_t count,
+                     double mean)
+{
+    exponentialv(bs, out, count, mean);
+}
+
+void exponentialf64v(struct randbs *bs,
+                     double *out,
+                     size_t count,
+                     double mean)
+{
+    exponentialv(bs, out, count, mean);
+}
+
+void poissonu32v(struct randbs *bs,
+                 uint32_t *out,
+                 size_t count,
+                 double mean)
+{
+    poissonv(bs, out, count, mean);
+}
+
+void poissonu64v(struct randbs *bs,
+                 uint64_t *out,
+                 size_t count,
+                 double mean)
+{
+    poissonv(bs, out, count, mean);
+}
+
+void binomialu32v(struct randbs *bs,
+                  uint32_t *out,
+                  size_t count,
+                  uint32_t n,
+                  double p)
+{
+    binomialv(bs, out, count, n, p);
+}
+
+void binomialu64v(struct randbs *bs,
+                  uint64_t *out,
+                  size_t count,
+                  uint64_t n,
+                  double p)
+{
+    binomialv(bs, out, count, n, p);
+}
+
+void geometricu32v(struct randbs *bs,
+                   uint32_t *out,
+                   size_t count,
+                   double p)
+{
+    geometricv(bs, out, count, p);
+}
+
+void geometricu64v(struct randbs *bs,
+                   uint64_t *out,
+                   size_t count,
+                   double p)
+{
+    geometricv(bs, out, count, p);
+}
+
+void zipfu32v(struct randbs *bs,
+              uint32_t *out,
+              size_t count,
+              uint32_t n,
+              double s)
+{
+    zipfv(bs, out, count, n, s);
+}
+
+void zipfu64v(struct randbs *bs,
+              uint64_t *out,
+              size_t count,
+              uint64_t n,
+              double s)
+{
+    zipfv(bs, out, count, n, s);
+}
+
+void wbernoulli_mask(struct wrandbs *bs,
+                     uint64_t *mask,
+                     size_t n_bits,
+                     double p_true)
+{
+    bernoulli_mask<struct wrandbs>(bs, mask, n_bits, p_true);
+}
+
+uint64_t wrandbs_bits(struct wrandbs *bs, unsigned want_bits)
+{
+    return bs_bits(bs, want_bits);
+}
+
+unsigned wrandbs_zeroes(struct wrandbs *bs, unsigned limit)
+{
+    return bs_zeroes(bs, limit);
+}
+
 void wrandi32v(struct wrandbs *bs,
                int32_t *out,
                size_t count,
@@ -395,6 +2097,33 @@ void wrandi32v(struct wrandbs *bs,
     randiv(bs, out, count, min, max);
 }
 
+void wrandi64v(struct wrandbs *bs,
+               int64_t *out,
+               size_t count,
+               int64_t min,
+               int64_t max)
+{
+    randiv(bs, out, count, min, max);
+}
+
+void wrandu32v(struct wrandbs *bs,
+               uint32_t *out,
+               size_t count,
+               uint32_t min,
+               uint32_t max)
+{
+    randiv(bs, out, count, min, max);
+}
+
+void wrandu64v(struct wrandbs *bs,
+               uint64_t *out,
+               size_t count,
+               uint64_t min,
+               uint64_t max)
+{
+    randiv(bs, out, count, min, max);
+}
+
 void wrandf32v(struct wrandbs *bs,
                float *out,
                size_t count,
@@ -403,6 +2132,273 @@ void wrandf32v(struct wrandbs *bs,
 {
     randfv(bs, out, count, min, max);
 }
-#endif
+
+void wrandf64v(struct wrandbs *bs,
+               double *out,
+               size_t count,
+               double min,
+               double max)
+{
+    randfv(bs, out, count, min, max);
+}
+
+void wgaussf32v(struct wrandbs *bs,
+                float *out,
+                size_t count,
+                double mean,
+                double stddev)
+{
+    gaussv(bs, out, count, mean, stddev);
+}
+
+float wgaussf32(struct wrandbs *bs, double mean, double stddev)
+{
+    return gauss<struct wrandbs, float>(bs, mean, stddev);
+}
+
+void wgaussf64v(struct wrandbs *bs,
+                double *out,
+                size_t count,
+                double mean,
+                double stddev)
+{
+    gaussv(bs, out, count, mean, stddev);
+}
+
+double wgaussf64(struct wrandbs *bs, double mean, double stddev)
+{
+    return gauss<struct wrandbs, double>(bs, mean, stddev);
+}
+
+void wexponentialf32v(struct wrandbs *bs,
+                      float *out,
+                      size_t count,
+                      double mean)
+{
+    exponentialv(bs, out, count, mean);
+}
+
+void wexponentialf64v(struct wrandbs *bs,
+                      double *out,
+                      size_t count,
+                      double mean)
+{
+    exponentialv(bs, out, count, mean);
+}
+
+void wpoissonu32v(struct wrandbs *bs,
+                  uint32_t *out,
+                  size_t count,
+                  double mean)
+{
+    poissonv(bs, out, count, mean);
+}
+
+void wpoissonu64v(struct wrandbs *bs,
+                  uint64_t *out,
+                  size_t count,
+                  double mean)
+{
+    poissonv(bs, out, count, mean);
+}
+
+void wbinomialu32v(struct wrandbs *bs,
+                   uint32_t *out,
+                   size_t count,
+                   uint32_t n,
+                   double p)
+{
+    binomialv(bs, out, count, n, p);
+}
+
+void wbinomialu64v(struct wrandbs *bs,
+                   uint64_t *out,
+                   size_t count,
+                   uint64_t n,
+                   double p)
+{
+    binomialv(bs, out, count, n, p);
+}
+
+void wgeometricu32v(struct wrandbs *bs,
+                    uint32_t *out,
+                    size_t count,
+                    double p)
+{
+    geometricv(bs, out, count, p);
+}
+
+void wgeometricu64v(struct wrandbs *bs,
+                    uint64_t *out,
+                    size_t count,
+                    double p)
+{
+    geometricv(bs, out, count, p);
+}
+
+void wzipfu32v(struct wrandbs *bs,
+               uint32_t *out,
+               size_t count,
+               uint32_t n,
+               double s)
+{
+    zipfv(bs, out, count, n, s);
+}
+
+void wzipfu64v(struct wrandbs *bs,
+               uint64_t *out,
+               size_t count,
+               uint64_t n,
+               double s)
+{
+    zipfv(bs, out, count, n, s);
+}
+
+#define RANDBS_GEN_RANDIV(BS, gen, name, T)                                 \
+    void name##_##gen(BS *bs, T *out, size_t count, T min, T max)           \
+    {                                                                       \
+        assert(bs->func == gen##_next);                                     \
+        randiv<BS, T, gen_##gen>(bs, out, count, min, max);                 \
+    }
+
+#define RANDBS_GEN_RANDFV(BS, gen, name, T)                                 \
+    void name##_##gen(BS *bs, T *out, size_t count, double min, double max) \
+    {                                                                       \
+        assert(bs->func == gen##_next);                                     \
+        randfv<BS, T, gen_##gen>(bs, out, count, min, max);                 \
+    }
+
+#define RANDBS_GEN_GAUSSV(BS, gen, name, T)                                 \
+    void name##_##gen(BS *bs, T *out, size_t count,                         \
+                      double mean, double stddev)                           \
+    {                                                                       \
+        assert(bs->func == gen##_next);                                     \
+        gaussv<BS, T, gen_##gen>(bs, out, count, mean, stddev);             \
+    }
+
+#define RANDBS_GEN_DEFINE(gen)                                              \
+    RANDBS_GEN_RANDIV(struct randbs, gen, randi8v, int8_t)                  \
+    RANDBS_GEN_RANDIV(struct randbs, gen, randi16v, int16_t)                \
+    RANDBS_GEN_RANDIV(struct randbs, gen, randi32v, int32_t)                \
+    RANDBS_GEN_RANDIV(struct randbs, gen, randi64v, int64_t)                \
+    RANDBS_GEN_RANDIV(struct randbs, gen, randu8v, uint8_t)                 \
+    RANDBS_GEN_RANDIV(struct randbs, gen, randu16v, uint16_t)               \
+    RANDBS_GEN_RANDIV(struct randbs, gen, randu32v, uint32_t)               \
+    RANDBS_GEN_RANDIV(struct randbs, gen, randu64v, uint64_t)               \
+    RANDBS_GEN_RANDFV(struct randbs, gen, randf32v, float)                  \
+    RANDBS_GEN_RANDFV(struct randbs, gen, randf64v, double)                 \
+    RANDBS_GEN_GAUSSV(struct randbs, gen, gaussf32v, float)                 \
+    RANDBS_GEN_GAUSSV(struct randbs, gen, gaussf64v, double)
+
+#define WRANDBS_GEN_DEFINE(gen)                                             \
+    RANDBS_GEN_RANDIV(struct wrandbs, gen, wrandi32v, int32_t)              \
+    RANDBS_GEN_RANDIV(struct wrandbs, gen, wrandi64v, int64_t)              \
+    RANDBS_GEN_RANDIV(struct wrandbs, gen, wrandu32v, uint32_t)             \
+    RANDBS_GEN_RANDIV(struct wrandbs, gen, wrandu64v, uint64_t)             \
+    RANDBS_GEN_RANDFV(struct wrandbs, gen, wrandf32v, float)                \
+    RANDBS_GEN_RANDFV(struct wrandbs, gen, wrandf64v, double)               \
+    RANDBS_GEN_GAUSSV(struct wrandbs, gen, wgaussf32v, float)               \
+    RANDBS_GEN_GAUSSV(struct wrandbs, gen, wgaussf64v, double)
+
+RANDBS_GEN_DEFINE(xoshiro128plus)
+RANDBS_GEN_DEFINE(xoshiro128plusplus)
+RANDBS_GEN_DEFINE(xoshiro128starstar)
+RANDBS_GEN_DEFINE(philox4x32)
+
+WRANDBS_GEN_DEFINE(xoshiro256plus)
+WRANDBS_GEN_DEFINE(xoshiro256plusplus)
+WRANDBS_GEN_DEFINE(xoshiro256starstar)
+
+void shuffle(struct randbs *rbs, void *base, size_t n_elems, size_t elem_size)
+{
+    with_elems(base, elem_size, [&](const auto &e) {
+        shuffle_fy<struct randbs, gen_dynamic<struct randbs>>(rbs, e,
+                                                              n_elems);
+    });
+}
+
+void shuffle_blocked(struct randbs *rbs,
+                     void *base,
+                     size_t n_elems,
+                     size_t elem_size,
+                     size_t block_elems,
+                     unsigned n_threads)
+{
+    shuffle_job job = { base, n_elems, elem_size, block_elems, 0, 0 };
+    size_t n_tasks;
+
+    hard_assert(block_elems > 0);
+
+    job.key = bs_next64(rbs);
+    if (n_elems < 2) return;
+
+    n_tasks = (n_elems + block_elems - 1) / block_elems;
+    parallel_for(n_threads, n_tasks, 1, &shuffle_level_chunk, &job);
+
+    while (n_tasks > 1) {
+        n_tasks = (n_tasks + 1) / 2;
+        job.level++;
+        parallel_for(n_threads, n_tasks, 1, &shuffle_level_chunk, &job);
+    }
+}
+
+void shuffle_parallel(struct randbs *rbs,
+                      void *base,
+                      size_t n_elems,
+                      size_t elem_size,
+                      unsigned n_threads)
+{
+    if (n_elems * elem_size < SHUFFLE_PARALLEL_MIN_BYTES)
+        shuffle(rbs, base, n_elems, elem_size);
+    else
+        shuffle_blocked(rbs, base, n_elems, elem_size,
+                        std::max<size_t>(1, SHUFFLE_BLOCK_BYTES / elem_size),
+                        n_threads);
+}
+
+#define RANDBS_PARALLEL_RANDIV(name, T)                                     \
+    void name##_parallel(const struct randbs *bs, T *out, size_t count,     \
+                         T min, T max, unsigned n_threads)                  \
+    {                                                                       \
+        fill_parallel<T, fill_kind::RANDIV>(bs, out, count, min, max,       \
+                                            0.0, 0.0, n_threads);           \
+    }
+
+RANDBS_PARALLEL_RANDIV(randi8v, int8_t)
+RANDBS_PARALLEL_RANDIV(randi16v, int16_t)
+RANDBS_PARALLEL_RANDIV(randi32v, int32_t)
+RANDBS_PARALLEL_RANDIV(randi64v, int64_t)
+RANDBS_PARALLEL_RANDIV(randu8v, uint8_t)
+RANDBS_PARALLEL_RANDIV(randu16v, uint16_t)
+RANDBS_PARALLEL_RANDIV(randu32v, uint32_t)
+RANDBS_PARALLEL_RANDIV(randu64v, uint64_t)
+
+void randf32v_parallel(const struct randbs *bs, float *out, size_t count,
+                       double min, double max, unsigned n_threads)
+{
+    fill_parallel<float, fill_kind::RANDFV>(bs, out, count, 0, 0,
+                                            min, max, n_threads);
+}
+
+void randf64v_parallel(const struct randbs *bs, double *out, size_t count,
+                       double min, double max, unsigned n_threads)
+{
+    fill_parallel<double, fill_kind::RANDFV>(bs, out, count, 0, 0,
+                                             min, max, n_threads);
+}
+
+void gaussf32v_parallel(const struct randbs *bs, float *out, size_t count,
+                        double mean, double stddev, unsigned n_threads)
+{
+    fill_parallel<float, fill_kind::GAUSSV>(bs, out, count, 0, 0,
+                                            mean, stddev, n_threads);
+}
+
+void gaussf64v_parallel(const struct randbs *bs, double *out, size_t count,
+                        double mean, double stddev, unsigned n_threads)
+{
+    fill_parallel<double, fill_kind::GAUSSV>(bs, out, count, 0, 0,
+                                             mean, stddev, n_threads);
+}
 
 } /* extern "C" */
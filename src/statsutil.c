@@ -15,6 +15,10 @@
 
 const double statsutil_nan = NAN;
 
+extern inline size_t hdrhist_index(const struct hdrhist *h, uint64_t value);
+extern inline void hdrhist_record(struct hdrhist *h, uint64_t value);
+extern inline void hdrhist_record_atomic(struct hdrhist *h, uint64_t value);
+
 static const uint8_t grid_colour = 236;
 static const uint8_t bucket_colours[2] = { 242, 249 };
 static const uint8_t bucket_bgcolours[2] = { 0, 232 };
@@ -54,6 +58,16 @@ double statsutil_round(double x)
     return round(x);
 }
 
+double statsutil_log(double x)
+{
+    return log(x);
+}
+
+double statsutil_exp(double x)
+{
+    return exp(x);
+}
+
 static inline void ansi_colour_256(FILE *out, uint8_t colour)
 {
     fprintf(out, "\e[38;5;%dm", colour);
@@ -3,6 +3,7 @@ extern "C" {
 
 #include "flrl/fputil.h"
 #include "flrl/hashmap.h"
+#include "flrl/parallel.h"
 #include "flrl/xassert.h"
 
 extern const double statsutil_nan;
@@ -15,6 +16,8 @@ extern void statsutil_free(void *ptr);
 extern double statsutil_ceil(double x);
 extern double statsutil_floor(double x);
 extern double statsutil_round(double x);
+extern double statsutil_log(double x);
+extern double statsutil_exp(double x);
 
 struct fmv_ctx {
     const void *max_key;
@@ -37,823 +40,3590 @@ static int hashmap_incr(const HashMap *hm,
 #include <limits>
 #include <type_traits>
 
+using f64x2 = fputil_f64x2;
+
+constexpr std::size_t kbn_sum_vecs = FPUTIL_KBN_SUM_VECS;
+
+/* compensated sum of f(values), spread over kbn_sum_vecs vectors of
+ * accumulators like kbn_sumf64v().  f maps a vector of two values to the
+ * vector of their addends */
+template<typename T, typename F>
+static double kbn_sum_map(const T *values, std::size_t n_values, F f)
+{
+    f64x2 sums[kbn_sum_vecs] = {}, comps[kbn_sum_vecs] = {};
+    double sum = 0, c = 0;
+    std::size_t i, v;
+
+    for (i = 0; i + 2 * kbn_sum_vecs <= n_values; i += 2 * kbn_sum_vecs) {
+        for (v = 0; v < kbn_sum_vecs; v++) {
+            const f64x2 x = { static_cast<double>(values[i + 2 * v]),
+                              static_cast<double>(values[i + 2 * v + 1]) };
+
+            two_sumf64x2_r(&sums[v], &comps[v], f(x));
+        }
+    }
+
+    kbn_sumf64x2_r(&sum, &c, sums, comps, kbn_sum_vecs);
+
+    for (; i < n_values; i++)
+        two_sumf64_r(&sum, &c, f(f64x2{ static_cast<double>(values[i]) })[0]);
+
+    return sum + c;
+}
+
 template<typename T>
 static double mean(const T *values, std::size_t n_values)
 {
-    double mean = 0, c = 0, scale = 1.0 / n_values;
-    std::size_t i;
+    const double scale = 1.0 / n_values;
 
     if (!n_values) return statsutil_nan;
 
-    for (i = 0; i < n_values; i++) {
-        kbn_sumf64_r(&mean, &c, scale * values[i]);
+    return kbn_sum_map(values, n_values,
+                       [scale](f64x2 x) { return scale * x; });
+}
+
+/* rearranges values[lo, hi) so that values[k] is the k-th smallest for
+ * every k in ks, which must be sorted, distinct, and within [lo, hi).
+ * like nth_element() for each k at once: selecting the middle k splits
+ * the range, and the ks on either side are selected within their own
+ * part, so m positions take expected O(n log m) rather than a full sort
+ */
+template<typename T>
+static void select_positions(T *values, std::size_t lo, std::size_t hi,
+                             const std::size_t *ks, std::size_t n_ks)
+{
+    while (n_ks) {
+        const std::size_t m = n_ks / 2, k = ks[m];
+
+        std::nth_element(values + lo, values + k, values + hi);
+        select_positions(values, lo, k, ks, m);
+
+        lo = k + 1;
+        ks += m + 1;
+        n_ks -= m + 1;
     }
+}
 
-    return mean + c;
+/* moves nans to the end, returning how many values are left before them */
+template<typename T>
+static std::size_t drop_nans(T *values, std::size_t n_values)
+{
+    if constexpr (std::is_floating_point_v<T>) {
+        return std::partition(values, values + n_values,
+                              [](T x){ return x == x; }) - values;
+    }
+    else {
+        return n_values;
+    }
 }
 
+/* malloc'd copy of values, without nans.  *pn_values is updated to the
+ * number copied.  returns NULL if there's nothing to copy, or on failure */
 template<typename T>
-static double median(const T *values, std::size_t n_values)
+static T *copy_values(const T *values, std::size_t *pn_values)
 {
     T *copy;
-    double median;
 
-    if (!n_values) return statsutil_nan;
+    if (!*pn_values) return NULL;
 
-    copy = (T*) statsutil_malloc(n_values * sizeof(values[0]));
-    if (!copy) return statsutil_nan;
+    copy = (T *) statsutil_malloc(*pn_values * sizeof(values[0]));
+    if (!copy) return NULL;
 
-    std::copy(values, values + n_values, copy);
-    std::sort(copy, copy + n_values);
+    if constexpr (std::is_floating_point_v<T>) {
+        *pn_values = std::copy_if(values, values + *pn_values, copy,
+                                  [](T x){ return x == x; }) - copy;
+    }
+    else {
+        std::copy(values, values + *pn_values, copy);
+    }
 
-    median = copy[n_values / 2];
+    return copy;
+}
 
-    if (!(n_values & 1))
-        median = 0.5 * (median + copy[n_values / 2 - 1]);
+/* calls f(chunk, begin, end) for each chunk, as parallel_for() does fn */
+template<typename F>
+static void parallel_call(void *arg, unsigned chunk,
+                          std::size_t begin, std::size_t end)
+{
+    (*static_cast<F *>(arg))(chunk, begin, end);
+}
 
-    statsutil_free(copy);
-    return median;
+template<typename F>
+static void parallel_for_fn(unsigned n_threads, std::size_t n_items,
+                            std::size_t min_chunk, F f)
+{
+    parallel_for(n_threads, n_items, min_chunk, &parallel_call<F>, &f);
 }
 
+/* lsd radix sort, for values too wide to count.  each value maps to an
+ * unsigned key in the same order: integers by flipping the sign bit, and
+ * floats by flipping the sign bit of positives and every bit of negatives.
+ * the first pass drops nans while making the keys, and counts every digit
+ * at once, so digits that are the same for every key can be skipped.
+ * each pass counts and scatters the values chunk by chunk, with chunks'
+ * offsets laid out in chunk order, so the sort is stable and its result
+ * doesn't depend on how many threads run the chunks.
+ */
 template<typename T>
-static inline double percentile(const T *values, std::size_t n_values,
-                                double p)
-{
-    /* https://en.wikipedia.org/wiki/Quartile#Method_4 */
-    std::size_t k;
-    double a;
-    T vk, vk1;
+constexpr bool is_radix_sortable_v = sizeof(T) == 4 || sizeof(T) == 8;
 
-    a = p * (n_values + 1);
+template<typename T>
+using radix_key_t = std::conditional_t<sizeof(T) == 8, uint64_t, uint32_t>;
 
-    if (a <= 1.0)
-        return values[0];
-    if (a >= n_values)
-        return values[n_values - 1];
+constexpr unsigned radix_bits = 8;
+constexpr std::size_t radix_size = std::size_t(1) << radix_bits;
 
-    k = a;
-    a -= k;
+template<typename T>
+constexpr unsigned radix_digits = 8 * sizeof(T) / radix_bits;
 
-    hard_assert(k > 0);
-    k--;
-    hard_assert(k < n_values - 1);
+/* below this many values, selection's lower overhead wins */
+constexpr std::size_t radix_min_values = 8192;
 
-    vk = values[k];
-    vk1 = values[k + 1];
+/* below this many values per thread, threads cost more than they save */
+constexpr std::size_t radix_min_chunk = 1 << 16;
 
-    return vk + a * (vk1 - vk);
+/* whether sorting n_values is quicker than selecting n_positions of them.
+ * on one thread, sorting 32-bit keys takes up to twice as long as
+ * selecting a median's middle positions, and about as long as selecting
+ * summary7's; 64-bit keys need twice the passes.  selection can't be
+ * shared between threads, though, and sorting can */
+template<typename T>
+static inline bool radix_sort_pays(std::size_t n_values,
+                                   std::size_t n_positions,
+                                   unsigned n_threads)
+{
+    /* in units of selecting a median */
+    const unsigned sort_cost = sizeof(T) == 8 ? 4 : 2;
+    const unsigned select_cost = n_positions > 2 ? 2 : 1;
+
+    return is_radix_sortable_v<T>
+           && n_values >= radix_min_values
+           && select_cost * parallel_chunks(n_threads, n_values,
+                                            radix_min_chunk) >= sort_cost;
 }
 
 template<typename T>
-static int summary7(Summary7 *s7,
-                    const T *values, std::size_t n_values,
-                    summary7_fence fence)
+static inline radix_key_t<T> radix_key(T x)
 {
-    T *copy = NULL;
-    double min, lno, q25, med, q75, hno, max;
+    using K = radix_key_t<T>;
+    constexpr unsigned top = 8 * sizeof(K) - 1;
+    constexpr K sign = K(1) << top;
+    K k;
 
-    hard_assert(fence >= FENCE_IQR15 && fence <= FENCE_PERC2);
+    __builtin_memcpy(&k, &x, sizeof(k));
 
-    min = lno = q25 = med = q75 = hno = max = statsutil_nan;
+    if constexpr (std::is_floating_point_v<T>)
+        return k ^ (-(k >> top) | sign);
+    else if constexpr (std::is_signed_v<T>)
+        return k ^ sign;
+    else
+        return k;
+}
 
-    if (!n_values) goto done;
-    /* n.b. can't short-circuit for tiny sets, haven't filtered nans yet */
+template<typename T>
+static inline T radix_value(radix_key_t<T> k)
+{
+    using K = radix_key_t<T>;
+    constexpr unsigned top = 8 * sizeof(K) - 1;
+    constexpr K sign = K(1) << top;
+    T x;
 
-    copy = (T *) statsutil_malloc(n_values * sizeof(values[0]));
-    if (!copy) return -1;
+    if constexpr (std::is_floating_point_v<T>)
+        k ^= ((k >> top) - 1) | sign;
+    else if constexpr (std::is_signed_v<T>)
+        k ^= sign;
 
-    if constexpr (std::is_floating_point_v<T>) {
-        auto copy_end = std::copy_if(values, values + n_values,
-                                     copy,
-                                     [](T x){ return x == x; });
-        n_values = copy_end - copy;
-        if (!n_values) goto done;
-    }
-    else {
-        std::copy(values, values + n_values, copy);
-    }
-    std::sort(copy, copy + n_values);
+    __builtin_memcpy(&x, &k, sizeof(x));
+    return x;
+}
 
-    min = copy[0];
-    max = copy[n_values - 1];
+template<typename K>
+static inline std::size_t radix_digit(K k, unsigned digit)
+{
+    return (k >> (digit * radix_bits)) & (radix_size - 1);
+}
 
-    if (n_values == 1) goto done;
+template<typename T>
+struct radix_ctx {
+    const T *values;
+    T *out;
+    radix_key_t<T> *src, *dst;
+    std::size_t *counts;    /* radix_digits<T> rows of radix_size per chunk */
+    std::size_t *ends;      /* where chunks' keys end after the first pass */
+    unsigned digit;
+};
 
-    q25 = percentile(copy, n_values, 0.25);
-    med = percentile(copy, n_values, 0.5);
-    q75 = percentile(copy, n_values, 0.75);
+/* makes each chunk's keys, packed at the start of the chunk, and counts
+ * each of their digits */
+template<typename T>
+static void radix_first_chunk(void *arg, unsigned chunk,
+                              std::size_t begin, std::size_t end)
+{
+    const radix_ctx<T> *ctx = static_cast<radix_ctx<T> *>(arg);
+    std::size_t *counts = ctx->counts
+                          + chunk * radix_digits<T> * radix_size;
+    radix_key_t<T> *keys = ctx->src;
+    std::size_t i, m = begin;
+    unsigned d;
 
-    if (fence == FENCE_IQR15) {
-        double flno, fhno, iqr15;
-        std::size_t i;
+    for (i = begin; i < end; i++) {
+        const T x = ctx->values[i];
 
-        iqr15 = 1.5 * (q75 - q25);
-        flno = q25 - iqr15;
-        fhno = q75 + iqr15;
+        if constexpr (std::is_floating_point_v<T>) {
+            if (x != x) continue;
+        }
 
-        i = 0;
-        while (i < n_values && copy[i] < flno)
-            i++;
-        lno = copy[i];
+        const radix_key_t<T> k = radix_key(x);
 
-        i = n_values - 1;
-        while (i > 0 && copy[i] > fhno)
-            i--;
-        hno = copy[i];
+        keys[m++] = k;
+        for (d = 0; d < radix_digits<T>; d++)
+            counts[d * radix_size + radix_digit(k, d)] ++;
     }
-    else {
-        double plno, phno;
-
-        switch (fence) {
-        case FENCE_OCTILE:
-            plno = 0.125;
-            break;
-        case FENCE_DECILE:
-            plno = 0.1;
-            break;
-        case FENCE_PERC2:
-            plno = 0.02;
-            break;
-        case FENCE_PERC9:
-            plno = 0.09;
-            break;
-        case FENCE_IQR15:
-        default:
-            abort(); /* unreachable */
-        }
 
-        phno = 1.0 - plno;
-        lno = percentile(copy, n_values, plno);
-        hno = percentile(copy, n_values, phno);
-    }
+    ctx->ends[chunk] = m;
+}
 
- done:
-    statsutil_free(copy);
+template<typename T>
+static void radix_count_chunk(void *arg, unsigned chunk,
+                              std::size_t begin, std::size_t end)
+{
+    const radix_ctx<T> *ctx = static_cast<radix_ctx<T> *>(arg);
+    std::size_t *counts = ctx->counts
+                          + (chunk * radix_digits<T> + ctx->digit)
+                            * radix_size;
+    std::size_t i;
 
-    *s7 = {
-        .min = min,
-        .lno = lno,
-        .q25 = q25,
-        .med = med,
-        .q75 = q75,
-        .hno = hno,
-        .max = max,
-        .fence = fence,
-    };
+    std::fill(counts, counts + radix_size, 0);
 
-    return 0;
+    for (i = begin; i < end; i++)
+        counts[radix_digit(ctx->src[i], ctx->digit)] ++;
 }
 
 template<typename T>
-static T mode(const T *values, std::size_t n_values, std::size_t *pfrequency)
+static void radix_scatter_chunk(void *arg, unsigned chunk,
+                                std::size_t begin, std::size_t end)
+{
+    const radix_ctx<T> *ctx = static_cast<radix_ctx<T> *>(arg);
+    std::size_t *offsets = ctx->counts
+                           + (chunk * radix_digits<T> + ctx->digit)
+                             * radix_size;
+    const radix_key_t<T> *src = ctx->src;
+    radix_key_t<T> *dst = ctx->dst;
+    const unsigned digit = ctx->digit;
+    std::size_t i;
+
+    for (i = begin; i < end; i++) {
+        const radix_key_t<T> k = src[i];
+
+        dst[offsets[radix_digit(k, digit)]++] = k;
+    }
+}
+
+template<typename T>
+static void radix_last_chunk(void *arg, unsigned chunk [[maybe_unused]],
+                             std::size_t begin, std::size_t end)
 {
-    HashMap counts;
-    struct fmv_ctx fmv_ctx = { NULL, NULL };
-    size_t i;
-    T mode;
+    const radix_ctx<T> *ctx = static_cast<radix_ctx<T> *>(arg);
+    std::size_t i;
 
-    static_assert(std::is_integral<T>::value, "Integral required");
+    for (i = begin; i < end; i++)
+        ctx->out[i] = radix_value<T>(ctx->src[i]);
+}
 
-    if (!n_values) {
-        if (pfrequency) *pfrequency = 0;
-        return 0;
+/* sorts values into out, which has room for *pn_values of them, leaving
+ * out nans and updating *pn_values to how many are left.  out's storage is
+ * used for keys on the way.  returns false, without having sorted
+ * anything, if memory couldn't be allocated */
+template<typename T>
+static bool radix_sort(T *out, const T *values, std::size_t *pn_values,
+                       unsigned n_threads)
+{
+    using K = radix_key_t<T>;
+    constexpr std::size_t stride = radix_digits<T> * radix_size;
+    const unsigned n_chunks = parallel_chunks(n_threads, *pn_values,
+                                              radix_min_chunk);
+    radix_ctx<T> ctx;
+    bool skip[radix_digits<T>];
+    std::size_t n_keys, c, x;
+    unsigned d;
+
+    ctx.values = values;
+    ctx.out = out;
+    ctx.src = reinterpret_cast<K *>(out);
+    ctx.dst = static_cast<K *>(statsutil_malloc(*pn_values * sizeof(K)));
+    ctx.counts = static_cast<std::size_t *>(
+                    statsutil_calloc(n_chunks * stride, sizeof(std::size_t)));
+    ctx.ends = static_cast<std::size_t *>(
+                    statsutil_malloc(n_chunks * sizeof(std::size_t)));
+
+    if (!ctx.dst || !ctx.counts || !ctx.ends) {
+        statsutil_free(ctx.dst);
+        statsutil_free(ctx.counts);
+        statsutil_free(ctx.ends);
+        return false;
     }
 
-    hashmap_init(&counts, n_values / 10);
+    parallel_for(n_threads, *pn_values, radix_min_chunk,
+                 &radix_first_chunk<T>, &ctx);
 
-    for (i = 0; i < n_values; i++) {
-        hashmap_mod(&counts, &values[i], sizeof(values[i]),
-                    reinterpret_cast<void *>(1),
-                    &hashmap_incr, NULL);
+    /* close the gaps left by nans, and total the counts in chunk 0's */
+    n_keys = ctx.ends[0];
+    for (c = 1; c < n_chunks; c++) {
+        const std::size_t begin = *pn_values / n_chunks * c
+                                  + std::min<std::size_t>(c, *pn_values
+                                                             % n_chunks);
+
+        std::copy(ctx.src + begin, ctx.src + ctx.ends[c], ctx.src + n_keys);
+        n_keys += ctx.ends[c] - begin;
+
+        for (x = 0; x < stride; x++)
+            ctx.counts[x] += ctx.counts[c * stride + x];
     }
 
-    hashmap_foreach(&counts, &find_max_value, &fmv_ctx);
+    for (d = 0; d < radix_digits<T>; d++) {
+        const std::size_t *counts = ctx.counts + d * radix_size;
 
-    mode = *static_cast<const T *>(fmv_ctx.max_key);
-    if (pfrequency) {
-        uintptr_t frequency = reinterpret_cast<uintptr_t>(fmv_ctx.max_value);
-        *pfrequency = frequency;
+        skip[d] = std::find(counts, counts + radix_size, n_keys)
+                  != counts + radix_size;
     }
 
-    hashmap_fini(&counts, NULL);
-    return mode;
-}
+    for (d = 0; d < radix_digits<T>; d++) {
+        const unsigned n_pass_chunks = parallel_chunks(n_threads, n_keys,
+                                                       radix_min_chunk);
+        std::size_t offset = 0;
 
-template<typename T>
-static double variance(const T *values, std::size_t n_values, double mean)
-{
-    double variance = 0, c = 0, scale;
-    std::size_t i;
+        if (skip[d]) continue;
 
-    if (!n_values) return statsutil_nan;
+        ctx.digit = d;
 
-    scale = 1.0 / (n_values - 1);
+        /* one chunk has chunk 0's totals already */
+        if (n_pass_chunks > 1)
+            parallel_for(n_threads, n_keys, radix_min_chunk,
+                         &radix_count_chunk<T>, &ctx);
 
-    for (i = 0; i < n_values; i++) {
-        double diff;
+        for (x = 0; x < radix_size; x++) {
+            for (c = 0; c < n_pass_chunks; c++) {
+                std::size_t *count = &ctx.counts[c * stride
+                                                 + d * radix_size + x];
+                const std::size_t n = *count;
+
+                *count = offset;
+                offset += n;
+            }
+        }
 
-        diff = values[i] - mean;
-        kbn_sumf64_r(&variance, &c, diff * diff);
+        parallel_for(n_threads, n_keys, radix_min_chunk,
+                     &radix_scatter_chunk<T>, &ctx);
+        std::swap(ctx.src, ctx.dst);
     }
 
-    return scale * (variance + c);
+    parallel_for(n_threads, n_keys, radix_min_chunk,
+                 &radix_last_chunk<T>, &ctx);
+
+    statsutil_free(reinterpret_cast<K *>(out) == ctx.src ? ctx.dst : ctx.src);
+    statsutil_free(ctx.counts);
+    statsutil_free(ctx.ends);
+
+    *pn_values = n_keys;
+    return true;
 }
 
+/* like copy_values(), but sorted by radix_sort() when that pays for
+ * reading n_positions from the copy, as *psorted says */
 template<typename T>
-static void stats(const T *values, std::size_t n_values,
-                  T *pmin, size_t *pmin_frequency,
-                  T *pmax, size_t *pmax_frequency,
-                  double *pmean, double *pvariance)
+static T *copy_values_sorted(const T *values, std::size_t *pn_values,
+                             std::size_t n_positions, bool *psorted,
+                             unsigned n_threads = 1)
 {
-    double mean, scale, variance, c;
-    T min, max;
-    std::size_t i, min_freq, max_freq;
+    *psorted = false;
 
-    min = std::numeric_limits<T>::max();
-    max = std::numeric_limits<T>::lowest();
+    if (radix_sort_pays<T>(*pn_values, n_positions, n_threads)) {
+        T *copy = (T *) statsutil_malloc(*pn_values * sizeof(values[0]));
 
-    /* min, max, mean */
-    min_freq = max_freq = mean = c = 0;
-    scale = 1.0 / n_values;
-    for (i = 0; i < n_values; i++) {
-        if (values[i] < min) {
-            min = values[i];
-            min_freq = 1;
-        }
-        else if (values[i] == min) {
-            min_freq ++;
+        if (copy && radix_sort(copy, values, pn_values, n_threads)) {
+            *psorted = true;
+            return copy;
         }
+        statsutil_free(copy);
+    }
 
-        if (values[i] > max) {
-            max = values[i];
-            max_freq = 1;
-        }
-        else if (values[i] == max) {
-            max_freq ++;
-        }
+    return copy_values(values, pn_values);
+}
 
-        kbn_sumf64_r(&mean, &c, scale * values[i]);
-    }
-    mean += c;
+/* values is anything indexable in sorted order */
+template<typename V>
+static inline double percentile(const V &values, std::size_t n_values,
+                                double p)
+{
+    /* https://en.wikipedia.org/wiki/Quartile#Method_4 */
+    using T = std::remove_cvref_t<decltype(values[0])>;
+    std::size_t k;
+    double a;
+    T vk, vk1;
 
-    if (pmin) *pmin = min;
-    if (pmin_frequency) *pmin_frequency = min_freq;
-    if (pmax) *pmax = max;
-    if (pmax_frequency) *pmax_frequency = max_freq;
-    if (pmean) *pmean = mean;
+    if (p != p) return statsutil_nan;
 
-    if (!pvariance) return;
+    a = p * (n_values + 1);
 
-    /* variance */
-    variance = c = 0;
-    scale = 1.0 / (n_values - 1);
-    for (i = 0; i < n_values; i++) {
-        double diff;
+    if (a <= 1.0)
+        return values[0];
+    if (a >= n_values)
+        return values[n_values - 1];
 
-        diff = values[i] - mean;
-        kbn_sumf64_r(&variance, &c, diff * diff);
+    k = a;
+    a -= k;
+
+    hard_assert(k > 0);
+    k--;
+    hard_assert(k < n_values - 1);
+
+    vk = values[k];
+    vk1 = values[k + 1];
+
+    return vk + a * (vk1 - vk);
+}
+
+static double fence_plno(summary7_fence fence)
+{
+    switch (fence) {
+    case FENCE_IQR15:
+        return 0.0;
+    case FENCE_OCTILE:
+        return 0.125;
+    case FENCE_DECILE:
+        return 0.1;
+    case FENCE_PERC2:
+        return 0.02;
+    case FENCE_PERC9:
+        return 0.09;
+    default:
+        abort(); /* unreachable */
     }
-    *pvariance = scale * (variance + c);
 }
 
+/* 8- and 16-bit integers have few enough distinct values that counting
+ * how often each occurs is cheaper than hashing or sorting them, once
+ * there are enough values to pay for clearing and scanning the counts.
+ * counts are indexed by value - lowest, so they're in sorted order.
+ */
 template<typename T>
-requires std::is_integral_v<T> || std::is_floating_point_v<T>
-static T *invent_thresholds(const T *values, std::size_t n_values,
-                            std::size_t *pn_thresholds)
+constexpr bool is_countable_v = std::is_integral_v<T> && sizeof(T) <= 2;
+
+template<typename T>
+constexpr std::size_t n_counts = std::size_t(1) << (8 * sizeof(T));
+
+template<typename T>
+constexpr std::size_t counting_min_values = sizeof(T) == 1 ? 0 : 4096;
+
+template<typename T>
+static inline std::size_t count_index(T x)
 {
-    T lb, ub, range, step;
-    T *thresholds;
-    std::size_t i, n_thresholds;
+    return x - std::numeric_limits<T>::lowest();
+}
 
-    lb = std::numeric_limits<T>::max();
-    ub = std::numeric_limits<T>::lowest();
-    for (i = 0; i < n_values; i++) {
-        lb = std::min(lb, values[i]);
-        ub = std::max(ub, values[i]);
+template<typename T>
+static inline T count_value(std::size_t i)
+{
+    return std::numeric_limits<T>::lowest() + i;
+}
+
+/* malloc'd array of n_counts<T> counts of each value, or NULL on failure.
+ * 8-bit values are tallied four ways, so runs of the same value don't
+ * serialise on one counter; 16-bit values have too many counts for that
+ * to pay for clearing them */
+template<typename T>
+static std::size_t *count_values(const T *values, std::size_t n_values)
+{
+    constexpr std::size_t n_tallies = sizeof(T) == 1 ? 4 : 1;
+    std::size_t *counts, i;
+
+    counts = (std::size_t *) statsutil_calloc(n_tallies * n_counts<T>,
+                                              sizeof(counts[0]));
+    if (!counts) return NULL;
+
+    if constexpr (n_tallies == 1) {
+        for (i = 0; i < n_values; i++)
+            counts[count_index(values[i])] ++;
+        return counts;
     }
 
-    if (std::is_floating_point_v<T>) {
-        ub = niceceil(ub);
-        range = niceceil(ub - lb);
-        lb = ub - range;
+    for (i = 0; i + 4 <= n_values; i += 4) {
+        counts[4 * count_index(values[i])] ++;
+        counts[4 * count_index(values[i + 1]) + 1] ++;
+        counts[4 * count_index(values[i + 2]) + 2] ++;
+        counts[4 * count_index(values[i + 3]) + 3] ++;
     }
-    else {
-        if (ub < std::numeric_limits<T>::max())
-            ub ++;
-        range = ub - lb;
+    for (; i < n_values; i++)
+        counts[4 * count_index(values[i])] ++;
+
+    for (i = 0; i < n_counts<T>; i++) {
+        counts[i] = counts[4 * i] + counts[4 * i + 1]
+                    + counts[4 * i + 2] + counts[4 * i + 3];
     }
 
-    n_thresholds = *pn_thresholds;
-    if (n_thresholds == 0) {
-        double t = range;
+    return counts;
+}
 
-        while (t >= 18.0)
-            t *= 1.0 / 3.0;
+/* below this many values per thread, threads cost more than they save */
+constexpr std::size_t count_min_chunk = 1 << 18;
 
-        while (t < 6.0)
-            t *= 3.0;
+/* count_values(), with each chunk of values counted by its own thread and
+ * the counts summed afterwards */
+template<typename T>
+static std::size_t *count_values(const T *values, std::size_t n_values,
+                                 unsigned n_threads)
+{
+    const unsigned n_chunks = parallel_chunks(n_threads, n_values,
+                                              count_min_chunk);
+    std::size_t **chunk_counts, *counts, c, i;
+
+    if (n_chunks == 1) return count_values(values, n_values);
+
+    chunk_counts = static_cast<std::size_t **>(
+                        statsutil_calloc(n_chunks, sizeof(chunk_counts[0])));
+    if (!chunk_counts) return NULL;
+
+    parallel_for_fn(n_threads, n_values, count_min_chunk,
+                    [=](unsigned chunk, std::size_t begin, std::size_t end) {
+                        chunk_counts[chunk] = count_values(values + begin,
+                                                           end - begin);
+                    });
+
+    counts = chunk_counts[0];
+    for (c = 1; c < n_chunks; c++) {
+        if (counts && chunk_counts[c]) {
+            for (i = 0; i < n_counts<T>; i++)
+                counts[i] += chunk_counts[c][i];
+        }
+        else {
+            statsutil_free(counts);
+            counts = NULL;
+        }
+        statsutil_free(chunk_counts[c]);
+    }
+
+    statsutil_free(chunk_counts);
+    return counts;
+}
+
+/* the sorted values, as seen through cumulative counts: values[k] is the
+ * first value with more than k values at or below it */
+template<typename T>
+struct counted_values {
+    const std::size_t *cumulative;
+
+    T operator[](std::size_t k) const
+    {
+        return count_value<T>(std::upper_bound(cumulative,
+                                               cumulative + n_counts<T>,
+                                               k) - cumulative);
+    }
+
+    /* how many values are below x */
+    std::size_t n_below(double x) const
+    {
+        x = statsutil_ceil(x) - std::numeric_limits<T>::lowest();
+
+        if (x <= 0) return 0;
+        if (x >= n_counts<T>) return cumulative[n_counts<T> - 1];
+        return cumulative[static_cast<std::size_t>(x) - 1];
+    }
+
+    /* how many values are at or below x */
+    std::size_t n_not_above(double x) const
+    {
+        x = statsutil_floor(x) - std::numeric_limits<T>::lowest();
+
+        if (x < 0) return 0;
+        if (x >= n_counts<T>) return cumulative[n_counts<T> - 1];
+        return cumulative[static_cast<std::size_t>(x)];
+    }
+};
+
+/* malloc'd cumulative counts of values, or NULL on failure */
+template<typename T>
+static std::size_t *count_cumulative(const T *values, std::size_t n_values,
+                                     unsigned n_threads = 1)
+{
+    std::size_t *counts, i;
+
+    counts = count_values(values, n_values, n_threads);
+    if (!counts) return NULL;
+
+    for (i = 1; i < n_counts<T>; i++)
+        counts[i] += counts[i - 1];
+
+    return counts;
+}
+
+template<typename T>
+static bool median_counted(double *pmedian,
+                           const T *values, std::size_t n_values,
+                           unsigned n_threads = 1)
+{
+    std::size_t *cumulative;
+
+    cumulative = count_cumulative(values, n_values, n_threads);
+    if (!cumulative) return false;
+
+    const counted_values<T> sorted = { cumulative };
+
+    *pmedian = sorted[n_values / 2];
+
+    if (!(n_values & 1))
+        *pmedian = 0.5 * (*pmedian + sorted[n_values / 2 - 1]);
+
+    statsutil_free(cumulative);
+    return true;
+}
+
+/* an array of values in order, as summary7_sorted() wants them */
+template<typename T>
+struct sorted_values {
+    const T *values;
+    std::size_t n_values;
+
+    T operator[](std::size_t k) const
+    {
+        return values[k];
+    }
+
+    /* how many values are below x */
+    std::size_t n_below(double x) const
+    {
+        return std::partition_point(values, values + n_values,
+                                    [x](T v) { return v < x; }) - values;
+    }
+
+    /* how many values are at or below x */
+    std::size_t n_not_above(double x) const
+    {
+        return std::partition_point(values, values + n_values,
+                                    [x](T v) { return !(v > x); }) - values;
+    }
+};
+
+/* summary7 of values already in order, as given by a view with operator[]
+ * for the kth least value, and n_below(x) and n_not_above(x) for how many
+ * values are below, and at or below, x */
+template<typename V>
+static void summary7_sorted(Summary7 *s7,
+                            const V &sorted, std::size_t n_values,
+                            summary7_fence fence)
+{
+    double min, lno, q25, med, q75, hno, max;
+
+    min = lno = q25 = med = q75 = hno = max = statsutil_nan;
+
+    if (!n_values) goto done;
+
+    min = percentile(sorted, n_values, 0.0);
+    max = percentile(sorted, n_values, 1.0);
+
+    if (n_values == 1) goto done;
+
+    q25 = percentile(sorted, n_values, 0.25);
+    med = percentile(sorted, n_values, 0.5);
+    q75 = percentile(sorted, n_values, 0.75);
+
+    if (fence == FENCE_IQR15) {
+        const double iqr15 = 1.5 * (q75 - q25);
+
+        lno = sorted[sorted.n_below(q25 - iqr15)];
+        hno = sorted[sorted.n_not_above(q75 + iqr15) - 1];
+    }
+    else {
+        const double plno = fence_plno(fence);
+
+        lno = percentile(sorted, n_values, plno);
+        hno = percentile(sorted, n_values, 1.0 - plno);
+    }
+
+ done:
+    *s7 = {
+        .min = min,
+        .lno = lno,
+        .q25 = q25,
+        .med = med,
+        .q75 = q75,
+        .hno = hno,
+        .max = max,
+        .fence = fence,
+    };
+}
+
+template<typename T>
+static bool summary7_counted(Summary7 *s7,
+                             const T *values, std::size_t n_values,
+                             summary7_fence fence, unsigned n_threads = 1)
+{
+    std::size_t *cumulative;
+
+    cumulative = count_cumulative(values, n_values, n_threads);
+    if (!cumulative) return false;
+
+    summary7_sorted(s7, counted_values<T>{ cumulative }, n_values, fence);
+
+    statsutil_free(cumulative);
+    return true;
+}
+
+/* ties go to the lowest value */
+template<typename T>
+static bool mode_counted(T *pmode, std::size_t *pfrequency,
+                         const T *values, std::size_t n_values,
+                         unsigned n_threads = 1)
+{
+    std::size_t *counts, i, max_i = 0;
+
+    counts = count_values(values, n_values, n_threads);
+    if (!counts) return false;
+
+    for (i = 1; i < n_counts<T>; i++) {
+        if (counts[i] > counts[max_i])
+            max_i = i;
+    }
+
+    *pmode = count_value<T>(max_i);
+    if (pfrequency) *pfrequency = counts[max_i];
+
+    statsutil_free(counts);
+    return true;
+}
+
+template<typename T>
+static bool stats_counted(const T *values, std::size_t n_values,
+                          T *pmin, size_t *pmin_frequency,
+                          T *pmax, size_t *pmax_frequency,
+                          double *pmean, double *pvariance)
+{
+    std::size_t *counts, i, lo, hi;
+    __int128 sum = 0;
+    double mean, variance = 0, c = 0;
+
+    counts = count_values(values, n_values);
+    if (!counts) return false;
+
+    for (lo = 0; !counts[lo]; lo++)
+        ;
+    for (hi = n_counts<T> - 1; !counts[hi]; hi--)
+        ;
+
+    /* the sum is exact, so the mean is correctly rounded */
+    for (i = lo; i <= hi; i++)
+        sum += static_cast<__int128>(counts[i]) * count_value<T>(i);
+    mean = static_cast<double>(sum) / n_values;
+
+    if (pmin) *pmin = count_value<T>(lo);
+    if (pmin_frequency) *pmin_frequency = counts[lo];
+    if (pmax) *pmax = count_value<T>(hi);
+    if (pmax_frequency) *pmax_frequency = counts[hi];
+    if (pmean) *pmean = mean;
+
+    if (pvariance) {
+        for (i = lo; i <= hi; i++) {
+            const double diff = count_value<T>(i) - mean;
+
+            if (counts[i])
+                kbn_sumf64_r(&variance, &c, counts[i] * (diff * diff));
+        }
+        *pvariance = (variance + c) / (n_values - 1);
+    }
+
+    statsutil_free(counts);
+    return true;
+}
+
+template<typename T>
+static double median_inplace(T *values, std::size_t n_values)
+{
+    double median;
+
+    n_values = drop_nans(values, n_values);
+    if (!n_values) return statsutil_nan;
+
+    if constexpr (is_countable_v<T>) {
+        if (n_values >= counting_min_values<T>
+            && median_counted(&median, values, n_values))
+            return median;
+    }
+
+    const std::size_t ks[2] = { (n_values - 1) / 2, n_values / 2 };
+    select_positions(values, 0, n_values, ks, ks[0] == ks[1] ? 1 : 2);
+
+    median = values[n_values / 2];
+
+    if (!(n_values & 1))
+        median = 0.5 * (median + values[n_values / 2 - 1]);
+
+    return median;
+}
+
+template<typename T>
+static double median(const T *values, std::size_t n_values,
+                     unsigned n_threads = 1)
+{
+    T *copy;
+    double median;
+    bool sorted;
+
+    if constexpr (is_countable_v<T>) {
+        if (n_values && n_values >= counting_min_values<T>
+            && median_counted(&median, values, n_values, n_threads))
+            return median;
+    }
+
+    copy = copy_values_sorted(values, &n_values, 2, &sorted, n_threads);
+    if (!copy) return statsutil_nan;
+
+    if (!sorted) {
+        median = median_inplace(copy, n_values);
+    }
+    else if (!n_values) {
+        median = statsutil_nan;
+    }
+    else {
+        median = copy[n_values / 2];
+
+        if (!(n_values & 1))
+            median = 0.5 * (median + copy[n_values / 2 - 1]);
+    }
+
+    statsutil_free(copy);
+    return median;
+}
+
+/* the positions percentile() reads for p, stored to ks.  returns how many,
+ * which is none for a nan p */
+static std::size_t percentile_positions(std::size_t n_values, double p,
+                                        std::size_t ks[2])
+{
+    const double a = p * (n_values + 1);
+
+    if (p != p) return 0;
+    if (a <= 1.0) {
+        ks[0] = 0;
+        return 1;
+    }
+    if (a >= n_values) {
+        ks[0] = n_values - 1;
+        return 1;
+    }
+
+    ks[0] = static_cast<std::size_t>(a) - 1;
+    ks[1] = ks[0] + 1;
+    return 2;
+}
+
+/* selects every position percentile() will read for ps.  ks is scratch
+ * space for 2 * n_ps positions */
+template<typename T>
+static void select_percentiles(T *values, std::size_t n_values,
+                               const double *ps, std::size_t n_ps,
+                               std::size_t *ks)
+{
+    std::size_t i, n_ks = 0;
+
+    for (i = 0; i < n_ps; i++)
+        n_ks += percentile_positions(n_values, ps[i], &ks[n_ks]);
+
+    std::sort(ks, ks + n_ks);
+    n_ks = std::unique(ks, ks + n_ks) - ks;
+
+    select_positions(values, 0, n_values, ks, n_ks);
+}
+
+template<typename T>
+static void quantiles_inplace(double *out,
+                              T *values, std::size_t n_values,
+                              const double *ps, std::size_t n_ps,
+                              std::size_t *ks)
+{
+    std::size_t i;
+
+    n_values = drop_nans(values, n_values);
+
+    if (!n_values) {
+        for (i = 0; i < n_ps; i++)
+            out[i] = statsutil_nan;
+        return;
+    }
+
+    select_percentiles(values, n_values, ps, n_ps, ks);
+
+    for (i = 0; i < n_ps; i++)
+        out[i] = percentile(values, n_values, ps[i]);
+}
+
+template<typename T>
+static int quantiles_inplace(double *out,
+                             T *values, std::size_t n_values,
+                             const double *ps, std::size_t n_ps)
+{
+    std::size_t *ks;
+
+    if (!n_ps) return 0;
+
+    ks = (std::size_t *) statsutil_malloc(2 * n_ps * sizeof(ks[0]));
+    if (!ks) return -1;
+
+    quantiles_inplace(out, values, n_values, ps, n_ps, ks);
+
+    statsutil_free(ks);
+    return 0;
+}
+
+template<typename T>
+static int quantiles(double *out,
+                     const T *values, std::size_t n_values,
+                     const double *ps, std::size_t n_ps)
+{
+    T *copy;
+    std::size_t i;
+    bool sorted;
+    int r = 0;
+
+    copy = copy_values_sorted(values, &n_values, 2 * n_ps, &sorted);
+    if (!copy && n_values) return -1;
+
+    if (!sorted) {
+        r = quantiles_inplace(out, copy, n_values, ps, n_ps);
+    }
+    else {
+        for (i = 0; i < n_ps; i++) {
+            out[i] = n_values ? percentile(copy, n_values, ps[i])
+                              : statsutil_nan;
+        }
+    }
+
+    statsutil_free(copy);
+    return r;
+}
+
+template<typename T>
+static void summary7_inplace(Summary7 *s7,
+                             T *values, std::size_t n_values,
+                             summary7_fence fence)
+{
+    double min, lno, q25, med, q75, hno, max;
+    double plno;
+    std::size_t ks[14];
+
+    hard_assert(fence >= FENCE_IQR15 && fence <= FENCE_PERC2);
+
+    min = lno = q25 = med = q75 = hno = max = statsutil_nan;
+
+    n_values = drop_nans(values, n_values);
+    if (!n_values) goto done;
+
+    if constexpr (is_countable_v<T>) {
+        if (n_values >= counting_min_values<T>
+            && summary7_counted(s7, values, n_values, fence))
+            return;
+    }
+
+    plno = fence_plno(fence);
+
+    {
+        /* min and max are the 0th and 100th percentiles */
+        const double ps[] = { 0.0, 1.0, 0.25, 0.5, 0.75, plno, 1.0 - plno };
+
+        select_percentiles(values, n_values, ps,
+                           fence == FENCE_IQR15 ? 5 : 7, ks);
+    }
+
+    min = percentile(values, n_values, 0.0);
+    max = percentile(values, n_values, 1.0);
+
+    if (n_values == 1) goto done;
+
+    q25 = percentile(values, n_values, 0.25);
+    med = percentile(values, n_values, 0.5);
+    q75 = percentile(values, n_values, 0.75);
+
+    if (fence == FENCE_IQR15) {
+        double flno, fhno, iqr15;
+        std::size_t i;
+
+        iqr15 = 1.5 * (q75 - q25);
+        flno = q25 - iqr15;
+        fhno = q75 + iqr15;
+
+        /* the least value not below flno, and the greatest not above
+         * fhno, which a linear scan finds without sorting */
+        lno = max;
+        hno = min;
+        for (i = 0; i < n_values; i++) {
+            const double x = values[i];
+
+            if (!(x < flno) && x < lno)
+                lno = x;
+            if (!(x > fhno) && x > hno)
+                hno = x;
+        }
+    }
+    else {
+        lno = percentile(values, n_values, plno);
+        hno = percentile(values, n_values, 1.0 - plno);
+    }
+
+ done:
+    *s7 = {
+        .min = min,
+        .lno = lno,
+        .q25 = q25,
+        .med = med,
+        .q75 = q75,
+        .hno = hno,
+        .max = max,
+        .fence = fence,
+    };
+}
+
+template<typename T>
+static int summary7(Summary7 *s7,
+                    const T *values, std::size_t n_values,
+                    summary7_fence fence, unsigned n_threads = 1)
+{
+    T *copy;
+    bool sorted;
+
+    if constexpr (is_countable_v<T>) {
+        if (n_values && n_values >= counting_min_values<T>
+            && summary7_counted(s7, values, n_values, fence, n_threads))
+            return 0;
+    }
+
+    copy = copy_values_sorted(values, &n_values, 2 * 7, &sorted,
+                              n_threads);
+    if (!copy && n_values) return -1;
+
+    if (sorted) {
+        hard_assert(fence >= FENCE_IQR15 && fence <= FENCE_PERC2);
+        summary7_sorted(s7, sorted_values<T>{ copy, n_values }, n_values,
+                        fence);
+    }
+    else {
+        summary7_inplace(s7, copy, n_values, fence);
+    }
+
+    statsutil_free(copy);
+    return 0;
+}
+
+template<typename T>
+static T mode(const T *values, std::size_t n_values, std::size_t *pfrequency)
+{
+    HashMap counts;
+    struct fmv_ctx fmv_ctx = { NULL, NULL };
+    size_t i;
+    T mode;
+
+    static_assert(std::is_integral<T>::value, "Integral required");
+
+    if (!n_values) {
+        if (pfrequency) *pfrequency = 0;
+        return 0;
+    }
+
+    if constexpr (is_countable_v<T>) {
+        if (n_values >= counting_min_values<T>
+            && mode_counted(&mode, pfrequency, values, n_values))
+            return mode;
+    }
+
+    hashmap_init(&counts, n_values / 10);
+
+    for (i = 0; i < n_values; i++) {
+        hashmap_mod(&counts, &values[i], sizeof(values[i]),
+                    reinterpret_cast<void *>(1),
+                    &hashmap_incr, NULL);
+    }
+
+    hashmap_foreach(&counts, &find_max_value, &fmv_ctx);
+
+    mode = *static_cast<const T *>(fmv_ctx.max_key);
+    if (pfrequency) {
+        uintptr_t frequency = reinterpret_cast<uintptr_t>(fmv_ctx.max_value);
+        *pfrequency = frequency;
+    }
+
+    hashmap_fini(&counts, NULL);
+    return mode;
+}
+
+template<typename T>
+static double variance(const T *values, std::size_t n_values, double mean)
+{
+    double scale;
+
+    if (!n_values) return statsutil_nan;
+
+    scale = 1.0 / (n_values - 1);
+
+    return scale * kbn_sum_map(values, n_values,
+                               [mean](f64x2 x) {
+                                   const f64x2 diff = x - mean;
+
+                                   return diff * diff;
+                               });
+}
+
+/* stats() works through blocks of values small enough to stay in cache,
+ * making three quick passes over each while it's there, so memory is only
+ * read once.  every pass is branch-free over vectors of lanes:
+ *
+ *  - min and max, with per-lane counts of each
+ *  - a compensated sum, giving the block's mean
+ *  - a compensated sum of squared deviations from the block's mean
+ *
+ * blocks are then combined as in Chan et al's parallel variance.
+ */
+constexpr std::size_t stats_block = 2048;
+constexpr std::size_t stats_vecs = 4;
+
+/* a block has few enough values per lane that T-sized counts can't wrap */
+template<typename T>
+struct stats_vec {
+    typedef T type __attribute__((vector_size(16)));
+    typedef decltype(type{} < type{}) mask;
+    typedef std::conditional_t<sizeof(T) == 1, uint8_t,
+            std::conditional_t<sizeof(T) == 2, uint16_t,
+            std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>>>
+            count_type;
+    typedef count_type count __attribute__((vector_size(16)));
+    static constexpr std::size_t lanes = sizeof(type) / sizeof(T);
+
+    static_assert(stats_block / (lanes * stats_vecs)
+                  <= std::numeric_limits<count_type>::max());
+};
+
+/* folds a min or max and its frequency into the running one */
+template<typename T>
+static inline void stats_extreme(T *extreme, std::size_t *freq,
+                                 T x, std::size_t x_freq, bool better)
+{
+    if (better) {
+        *extreme = x;
+        *freq = x_freq;
+    }
+    else if (x == *extreme) {
+        *freq += x_freq;
+    }
+}
+
+template<typename T>
+static void stats(const T *values, std::size_t n_values,
+                  T *pmin, size_t *pmin_frequency,
+                  T *pmax, size_t *pmax_frequency,
+                  double *pmean, double *pvariance)
+{
+    using sv = stats_vec<T>;
+    double mean = 0, mean_c = 0, m2 = 0, m2_c = 0, run_mean = 0, scale;
+    std::size_t base, i, l, run_n = 0, min_freq = 0, max_freq = 0;
+    T min, max;
+
+    /* the vector loop below is cheap enough to stay ahead for longer */
+    if constexpr (is_countable_v<T>) {
+        if (n_values && n_values >= 8 * counting_min_values<T>
+            && stats_counted(values, n_values,
+                             pmin, pmin_frequency, pmax, pmax_frequency,
+                             pmean, pvariance))
+            return;
+    }
+
+    min = std::numeric_limits<T>::max();
+    max = std::numeric_limits<T>::lowest();
+
+    scale = 1.0 / n_values;
+
+    for (base = 0; base < n_values; base += stats_block) {
+        const T *block = values + base;
+        const std::size_t len = std::min(stats_block, n_values - base);
+        typename sv::type lane_min[stats_vecs], lane_max[stats_vecs];
+        typename sv::count lane_min_freq[stats_vecs] = {};
+        typename sv::count lane_max_freq[stats_vecs] = {};
+        std::size_t v;
+        double block_mean;
+
+        /* min, max */
+        for (v = 0; v < stats_vecs; v++) {
+            lane_min[v] = typename sv::type{} + std::numeric_limits<T>::max();
+            lane_max[v] = typename sv::type{}
+                          + std::numeric_limits<T>::lowest();
+        }
+
+        for (i = 0; i + sv::lanes * stats_vecs <= len;
+             i += sv::lanes * stats_vecs) {
+            for (v = 0; v < stats_vecs; v++) {
+                typename sv::type x;
+
+                __builtin_memcpy(&x, &block[i + v * sv::lanes], sizeof(x));
+
+                const typename sv::mask lt = x < lane_min[v];
+                const typename sv::mask gt = x > lane_max[v];
+                const typename sv::mask le = lt | (x == lane_min[v]);
+                const typename sv::mask ge = gt | (x == lane_max[v]);
+
+                lane_min_freq[v] = (lane_min_freq[v]
+                                    & ~(typename sv::count) lt)
+                                   - (typename sv::count) le;
+                lane_min[v] = lt ? x : lane_min[v];
+                lane_max_freq[v] = (lane_max_freq[v]
+                                    & ~(typename sv::count) gt)
+                                   - (typename sv::count) ge;
+                lane_max[v] = gt ? x : lane_max[v];
+            }
+        }
+
+        for (v = 0; v < stats_vecs; v++) {
+            for (l = 0; l < sv::lanes; l++) {
+                stats_extreme(&min, &min_freq,
+                              lane_min[v][l], lane_min_freq[v][l],
+                              lane_min[v][l] < min);
+                stats_extreme(&max, &max_freq,
+                              lane_max[v][l], lane_max_freq[v][l],
+                              lane_max[v][l] > max);
+            }
+        }
+        for (; i < len; i++) {
+            stats_extreme(&min, &min_freq, block[i], 1, block[i] < min);
+            stats_extreme(&max, &max_freq, block[i], 1, block[i] > max);
+        }
+
+        /* mean */
+        block_mean = kbn_sum_map(block, len,
+                                 [scale](f64x2 x) { return scale * x; });
+        two_sumf64_r(&mean, &mean_c, block_mean);
+
+        if (!pvariance) continue;
+
+        /* this block's squared deviations from its mean, merged into m2 */
+        double block_m2, delta;
+
+        block_mean *= 1.0 * n_values / len;
+        block_m2 = kbn_sum_map(block, len,
+                               [block_mean](f64x2 x) {
+                                   const f64x2 diff = x - block_mean;
+
+                                   return diff * diff;
+                               });
+
+        delta = block_mean - run_mean;
+        run_n += len;
+        run_mean += delta * len / run_n;
+        two_sumf64_r(&m2, &m2_c, block_m2);
+        two_sumf64_r(&m2, &m2_c, delta * delta * (run_n - len) / run_n * len);
+    }
+    mean += mean_c;
+
+    if (pmin) *pmin = min;
+    if (pmin_frequency) *pmin_frequency = min_freq;
+    if (pmax) *pmax = max;
+    if (pmax_frequency) *pmax_frequency = max_freq;
+    if (pmean) *pmean = mean;
+    if (pvariance) *pvariance = (m2 + m2_c) / (n_values - 1);
+}
+
+/* the member of a stats_acc_value that holds a T */
+template<typename T>
+static inline T stats_acc_get(const union stats_acc_value &v)
+{
+    if constexpr (std::is_floating_point_v<T>)
+        return v.f;
+    else if constexpr (std::is_signed_v<T>)
+        return v.i;
+    else
+        return v.u;
+}
+
+template<typename T>
+static inline void stats_acc_set(union stats_acc_value *v, T x)
+{
+    if constexpr (std::is_floating_point_v<T>)
+        v->f = x;
+    else if constexpr (std::is_signed_v<T>)
+        v->i = x;
+    else
+        v->u = x;
+}
+
+/* folds the stats of n more values into acc */
+template<typename T>
+static void stats_acc_add(struct stats_acc *acc, std::size_t n,
+                          T min, std::size_t min_freq,
+                          T max, std::size_t max_freq,
+                          double mean, double m2)
+{
+    std::size_t run_n;
+    double delta;
+    T acc_min, acc_max;
+
+    if (!n) return;
+
+    /* start from stats()'s initial extremes, so nans are skipped alike */
+    if (!acc->n_values) {
+        *acc = stats_acc{};
+        stats_acc_set(&acc->min, std::numeric_limits<T>::max());
+        stats_acc_set(&acc->max, std::numeric_limits<T>::lowest());
+    }
+
+    acc_min = stats_acc_get<T>(acc->min);
+    acc_max = stats_acc_get<T>(acc->max);
+    stats_extreme(&acc_min, &acc->min_frequency, min, min_freq, min < acc_min);
+    stats_extreme(&acc_max, &acc->max_frequency, max, max_freq, max > acc_max);
+    stats_acc_set(&acc->min, acc_min);
+    stats_acc_set(&acc->max, acc_max);
+
+    run_n = acc->n_values + n;
+    delta = mean - (acc->mean + acc->mean_c);
+    two_sumf64_r(&acc->mean, &acc->mean_c, delta * n / run_n);
+    two_sumf64_r(&acc->m2, &acc->m2_c, m2);
+    two_sumf64_r(&acc->m2, &acc->m2_c,
+                 delta * delta * acc->n_values / run_n * n);
+    acc->n_values = run_n;
+}
+
+template<typename T>
+static void stats_acc_push(struct stats_acc *acc, T value)
+{
+    stats_acc_add(acc, 1, value, 1, value, 1, value, 0.0);
+}
+
+template<typename T>
+static void stats_acc_push(struct stats_acc *acc,
+                           const T *values, std::size_t n_values)
+{
+    std::size_t min_freq, max_freq;
+    double mean, variance;
+    T min, max;
+
+    if (n_values < 2) {
+        if (n_values) stats_acc_push(acc, values[0]);
+        return;
+    }
+
+    stats(values, n_values, &min, &min_freq, &max, &max_freq,
+          &mean, &variance);
+    stats_acc_add(acc, n_values, min, min_freq, max, max_freq,
+                  mean, variance * (n_values - 1));
+}
+
+template<typename T>
+static void stats_acc_merge(struct stats_acc *acc,
+                            const struct stats_acc *other)
+{
+    stats_acc_add(acc, other->n_values,
+                  stats_acc_get<T>(other->min), other->min_frequency,
+                  stats_acc_get<T>(other->max), other->max_frequency,
+                  other->mean + other->mean_c, other->m2 + other->m2_c);
+}
+
+template<typename T>
+static void stats_acc_result(const struct stats_acc *acc,
+                             T *pmin, size_t *pmin_frequency,
+                             T *pmax, size_t *pmax_frequency,
+                             double *pmean, double *pvariance)
+{
+    const std::size_t n = acc->n_values;
+
+    if (pmin)
+        *pmin = n ? stats_acc_get<T>(acc->min) : std::numeric_limits<T>::max();
+    if (pmin_frequency) *pmin_frequency = n ? acc->min_frequency : 0;
+    if (pmax)
+        *pmax = n ? stats_acc_get<T>(acc->max)
+                  : std::numeric_limits<T>::lowest();
+    if (pmax_frequency) *pmax_frequency = n ? acc->max_frequency : 0;
+    if (pmean) *pmean = n ? acc->mean + acc->mean_c : statsutil_nan;
+    if (pvariance)
+        *pvariance = n > 1 ? (acc->m2 + acc->m2_c) / (n - 1) : statsutil_nan;
+}
+
+/* the _parallel reductions cut values into blocks of reduce_block, reduce
+ * each block to a partial result, and merge the partials in block order.
+ * threads share out whole blocks, so the result doesn't depend on how
+ * many there are.  inputs of a single block are just reduced directly.
+ */
+constexpr std::size_t reduce_block = 1 << 18;
+
+/* malloc'd array of reduce(block, len) for each block of values, or NULL
+ * on failure.  *pn_blocks is set to how many there are */
+template<typename P, typename T, typename F>
+static P *reduce_blocks(const T *values, std::size_t n_values,
+                        unsigned n_threads, std::size_t *pn_blocks, F reduce)
+{
+    const std::size_t n_blocks = (n_values + reduce_block - 1) / reduce_block;
+    P *partials;
+
+    partials = static_cast<P *>(statsutil_malloc(n_blocks * sizeof(P)));
+    if (!partials) return NULL;
+
+    parallel_for_fn(n_threads, n_blocks, 1,
+                    [&](unsigned, std::size_t begin, std::size_t end) {
+                        std::size_t b;
+
+                        for (b = begin; b < end; b++) {
+                            const std::size_t base = b * reduce_block;
+
+                            partials[b] = reduce(values + base,
+                                                 std::min(reduce_block,
+                                                          n_values - base));
+                        }
+                    });
+
+    *pn_blocks = n_blocks;
+    return partials;
+}
+
+template<typename T>
+static double mean_parallel(const T *values, std::size_t n_values,
+                            unsigned n_threads)
+{
+    const double scale = 1.0 / n_values;
+    double *partials, sum = 0, c = 0;
+    std::size_t n_blocks, b;
+
+    if (n_values <= reduce_block) return mean(values, n_values);
+
+    partials = reduce_blocks<double>(values, n_values, n_threads, &n_blocks,
+                                     [scale](const T *block, std::size_t len) {
+        return kbn_sum_map(block, len, [scale](f64x2 x) { return scale * x; });
+    });
+    if (!partials) return mean(values, n_values);
+
+    for (b = 0; b < n_blocks; b++)
+        two_sumf64_r(&sum, &c, partials[b]);
+
+    statsutil_free(partials);
+    return sum + c;
+}
+
+template<typename T>
+static double variance_parallel(const T *values, std::size_t n_values,
+                                double mean, unsigned n_threads)
+{
+    double *partials, sum = 0, c = 0;
+    std::size_t n_blocks, b;
+
+    if (n_values <= reduce_block) return variance(values, n_values, mean);
+
+    partials = reduce_blocks<double>(values, n_values, n_threads, &n_blocks,
+                                     [mean](const T *block, std::size_t len) {
+        return kbn_sum_map(block, len, [mean](f64x2 x) {
+            const f64x2 diff = x - mean;
+
+            return diff * diff;
+        });
+    });
+    if (!partials) return variance(values, n_values, mean);
+
+    for (b = 0; b < n_blocks; b++)
+        two_sumf64_r(&sum, &c, partials[b]);
+
+    statsutil_free(partials);
+    return (sum + c) / (n_values - 1);
+}
+
+template<typename T>
+static void stats_parallel(const T *values, std::size_t n_values,
+                           T *pmin, size_t *pmin_frequency,
+                           T *pmax, size_t *pmax_frequency,
+                           double *pmean, double *pvariance,
+                           unsigned n_threads)
+{
+    struct stats_acc *partials, acc = {};
+    std::size_t n_blocks, b;
+
+    if (n_values > reduce_block) {
+        partials = reduce_blocks<struct stats_acc>(
+                        values, n_values, n_threads, &n_blocks,
+                        [](const T *block, std::size_t len) {
+                            struct stats_acc block_acc = {};
+
+                            stats_acc_push(&block_acc, block, len);
+                            return block_acc;
+                        });
+        if (partials) {
+            for (b = 0; b < n_blocks; b++)
+                stats_acc_merge<T>(&acc, &partials[b]);
+
+            stats_acc_result(&acc, pmin, pmin_frequency,
+                             pmax, pmax_frequency, pmean, pvariance);
+            statsutil_free(partials);
+            return;
+        }
+    }
+
+    stats(values, n_values, pmin, pmin_frequency, pmax, pmax_frequency,
+          pmean, pvariance);
+}
+
+/* the mode of values too wide to count is found from a sorted copy, which
+ * threads can share, where the serial mode() hashes them.  either way, ties
+ * go to the least value, so the result doesn't depend on the threads */
+template<typename T>
+static T mode_parallel(const T *values, std::size_t n_values,
+                       std::size_t *pfrequency, unsigned n_threads)
+{
+    T mode;
+
+    if (!n_values) {
+        if (pfrequency) *pfrequency = 0;
+        return 0;
+    }
+
+    if constexpr (is_countable_v<T>) {
+        if (mode_counted(&mode, pfrequency, values, n_values, n_threads))
+            return mode;
+    }
+    else if constexpr (is_radix_sortable_v<T>) {
+        T *sorted = (T *) statsutil_malloc(n_values * sizeof(values[0]));
+        std::size_t i, run = 1, frequency = 1;
+
+        if (sorted && radix_sort(sorted, values, &n_values, n_threads)) {
+            mode = sorted[0];
+
+            for (i = 1; i < n_values; i++) {
+                run = sorted[i] == sorted[i - 1] ? run + 1 : 1;
+
+                if (run > frequency) {
+                    mode = sorted[i];
+                    frequency = run;
+                }
+            }
+
+            statsutil_free(sorted);
+            if (pfrequency) *pfrequency = frequency;
+            return mode;
+        }
+        statsutil_free(sorted);
+    }
+
+    return ::mode(values, n_values, pfrequency);
+}
+
+template<typename T>
+requires std::is_integral_v<T> || std::is_floating_point_v<T>
+static T *invent_thresholds(const T *values, std::size_t n_values,
+                            std::size_t *pn_thresholds)
+{
+    T lb, ub, range, step;
+    T *thresholds;
+    std::size_t i, n_thresholds;
+
+    lb = std::numeric_limits<T>::max();
+    ub = std::numeric_limits<T>::lowest();
+    for (i = 0; i < n_values; i++) {
+        lb = std::min(lb, values[i]);
+        ub = std::max(ub, values[i]);
+    }
+
+    if (std::is_floating_point_v<T>) {
+        ub = niceceil(ub);
+        range = niceceil(ub - lb);
+        lb = ub - range;
+    }
+    else {
+        if (ub < std::numeric_limits<T>::max())
+            ub ++;
+        range = ub - lb;
+    }
+
+    n_thresholds = *pn_thresholds;
+    if (n_thresholds == 0) {
+        double t = range;
+
+        while (t >= 18.0)
+            t *= 1.0 / 3.0;
+
+        while (t < 6.0)
+            t *= 3.0;
+
+        n_thresholds = statsutil_ceil(t);
+    }
+
+    if (std::is_floating_point_v<T>) {
+        step = niceceil(range / n_thresholds);
+    }
+    else {
+        n_thresholds = std::min(n_thresholds, (size_t) range);
+        step = statsutil_ceil(1.0 * range / n_thresholds);
+    }
+
+    thresholds = (T*) statsutil_malloc(n_thresholds * sizeof(thresholds[0]));
+    if (!thresholds) return NULL;
+
+    if (lb == std::numeric_limits<T>::lowest())
+        lb += step;
+    for (i = 0; i < n_thresholds; i++) {
+        thresholds[i] = i * step + lb;
+    }
+
+    *pn_thresholds = n_thresholds;
+    return thresholds;
+}
+
+/* sets up hist's buckets for values split by n_thresholds thresholds */
+static void histogram_init(Histogram *hist, const char *title,
+                           std::size_t n_thresholds)
+{
+    memset(hist, 0, sizeof(*hist));
+    hist->title = statsutil_strdup(title);
+    hist->n_buckets = n_thresholds + 1;
+    hist->buckets = (hist_bucket *) statsutil_calloc(hist->n_buckets,
+                                                     sizeof(hist->buckets[0]));
+}
+
+/* fills in the rest of hist once its buckets' raw frequencies are counted */
+template<typename T>
+static void histogram_finish(Histogram *hist,
+                             const T *thresholds, std::size_t n_thresholds,
+                             std::size_t n_values)
+{
+    std::size_t min_freq_raw = std::numeric_limits<std::size_t>::max();
+    std::size_t max_freq_raw = 0;
+    std::size_t i;
+    double fpp;
+
+    /* compute percent frequencies, min/max raw frequency, and labels */
+    for (i = 0; i < hist->n_buckets; i++) {
+        struct hist_bucket *bucket = &hist->buckets[i];
+
+        bucket->freq_pc = 100.0 * bucket->freq_raw / n_values;
+        min_freq_raw = std::min(min_freq_raw, bucket->freq_raw);
+        max_freq_raw = std::max(max_freq_raw, bucket->freq_raw);
+
+        bucket->skip_if_zero = false;
+
+        if (i == 0) {
+            if (std::numeric_limits<T>::is_signed)
+                strcpy(bucket->lb_label, "-inf");
+            else
+                strcpy(bucket->lb_label, "0");
+            bucket->skip_if_zero = true;
+        }
+        else {
+            snprintf(bucket->lb_label, sizeof(bucket->lb_label),
+                     "%g", (double) thresholds[i - 1]);
+        }
+
+        if (i == n_thresholds) {
+            strcpy(bucket->ub_label, "+inf");
+            bucket->skip_if_zero = true;
+        }
+        else {
+            snprintf(bucket->ub_label, sizeof(bucket->ub_label),
+                     "<%g", (double) thresholds[i]);
+        }
+    }
+
+    /* compute grid lines and pips */
+    fpp = niceceil(max_freq_raw / 60.0);
+    for (i = 0; i < 6; i++) {
+        hist->grid[i] = (i + 1) * fpp * 10.0;
+    }
+    for (i = 0; i < hist->n_buckets; i++) {
+        struct hist_bucket *bucket = &hist->buckets[i];
+        bucket->pips = statsutil_round(bucket->freq_raw / fpp);
+    }
+}
+
+/* finds a value's bucket, the index of the first threshold it's below
+ * (or n_thresholds if none), without scanning every threshold.  if the
+ * thresholds are about evenly spaced, as invent_thresholds() makes them,
+ * the index is worked out directly and then nudged onto the right
+ * threshold; otherwise, if they're in order, several values at once are
+ * binary searched in lockstep, without branches.  thresholds out of order
+ * (or nan) are scanned as they always were.
+ */
+enum hist_search { HIST_EVEN, HIST_BINARY, HIST_LINEAR };
+
+template<typename T>
+struct hist_bucketer {
+    const T *thresholds;
+    std::size_t n_thresholds;
+    double lb, inv_step;
+    hist_search search;
+
+    std::size_t even(T x) const
+    {
+        const double d = (static_cast<double>(x) - lb) * inv_step + 1.0;
+        std::size_t k;
+
+        k = !(d < n_thresholds) ? n_thresholds
+            : d > 0 ? static_cast<std::ptrdiff_t>(d) : 0;
+
+        while (k < n_thresholds && !(x < thresholds[k]))
+            k++;
+        while (k > 0 && x < thresholds[k - 1])
+            k--;
+        return k;
+    }
+
+    template<std::size_t N>
+    void binary(const T *x, std::size_t *k) const
+    {
+        const T *base[N];
+        std::size_t len = n_thresholds, j;
+
+        for (j = 0; j < N; j++)
+            base[j] = thresholds;
+
+        while (len > 1) {
+            const std::size_t half = len / 2;
+
+            for (j = 0; j < N; j++)
+                base[j] = x[j] < base[j][half] ? base[j] : base[j] + half;
+            len -= half;
+        }
+
+        for (j = 0; j < N; j++)
+            k[j] = base[j] - thresholds + !(x[j] < *base[j]);
+    }
+
+    std::size_t linear(T x) const
+    {
+        std::size_t t;
+
+        for (t = 0; t < n_thresholds; t++) {
+            if (x < thresholds[t]) break;
+        }
+        return t;
+    }
+};
+
+template<typename T>
+static hist_bucketer<T> hist_bucketer_for(const T *thresholds,
+                                          std::size_t n_thresholds)
+{
+    hist_bucketer<T> b = {
+        .thresholds = thresholds,
+        .n_thresholds = n_thresholds,
+        .lb = 0.0,
+        .inv_step = 0.0,
+        .search = HIST_BINARY,
+    };
+    double step;
+    std::size_t i;
+
+    /* binary() reads at least one threshold; every value is in bucket 0 */
+    if (!n_thresholds) {
+        b.search = HIST_LINEAR;
+        return b;
+    }
+
+    for (i = 1; i < n_thresholds; i++) {
+        if (!(thresholds[i - 1] <= thresholds[i])) {
+            b.search = HIST_LINEAR;
+            return b;
+        }
+    }
+
+    if (n_thresholds < 2) return b;
+
+    b.lb = thresholds[0];
+    step = (static_cast<double>(thresholds[n_thresholds - 1]) - b.lb)
+           / (n_thresholds - 1);
+    for (i = 0; i < n_thresholds; i++) {
+        const double off = thresholds[i] - (b.lb + i * step);
+
+        /* close enough that the nudging stays short */
+        if (!(off < 0.25 * step && off > -0.25 * step)) return b;
+    }
+
+    b.inv_step = 1.0 / step;
+    b.search = HIST_EVEN;
+    return b;
+}
+
+/* copies of the counts that successive values alternate between, so runs
+ * of values in one bucket don't wait on each other's increments */
+constexpr std::size_t hist_count_copies = 4;
+constexpr std::size_t hist_lockstep = 8;
+
+/* counts values into hist_count_copies interleaved arrays of
+ * n_thresholds + 1 counts */
+template<typename T>
+static void histogram_count(const hist_bucketer<T> &bucketer,
+                            const T *values, std::size_t n_values,
+                            std::size_t *counts)
+{
+    /* a copy, which the stores to counts can't alias */
+    const hist_bucketer<T> b = bucketer;
+    const std::size_t stride = b.n_thresholds + 1;
+    std::size_t i = 0, j;
+
+    switch (b.search) {
+    case HIST_EVEN:
+        for (; i < n_values; i++)
+            counts[(i % hist_count_copies) * stride + b.even(values[i])]++;
+        break;
+    case HIST_BINARY:
+        for (; i + hist_lockstep <= n_values; i += hist_lockstep) {
+            std::size_t k[hist_lockstep];
+
+            b.template binary<hist_lockstep>(values + i, k);
+            for (j = 0; j < hist_lockstep; j++)
+                counts[(j % hist_count_copies) * stride + k[j]]++;
+        }
+        for (; i < n_values; i++) {
+            std::size_t k;
+
+            b.template binary<1>(values + i, &k);
+            counts[k]++;
+        }
+        break;
+    case HIST_LINEAR:
+        for (; i < n_values; i++)
+            counts[(i % hist_count_copies) * stride + b.linear(values[i])]++;
+        break;
+    }
+}
+
+template<typename T>
+struct hist_count_ctx {
+    hist_bucketer<T> bucketer;
+    const T *values;
+    std::size_t *counts;
+};
+
+/* each chunk counts into its own set of copies */
+template<typename T>
+static void histogram_count_chunk(void *arg, unsigned chunk,
+                                  std::size_t begin, std::size_t end)
+{
+    const hist_count_ctx<T> *ctx = static_cast<hist_count_ctx<T> *>(arg);
+    const std::size_t size = hist_count_copies
+                             * (ctx->bucketer.n_thresholds + 1);
+
+    histogram_count(ctx->bucketer, ctx->values + begin, end - begin,
+                    ctx->counts + chunk * size);
+}
+
+/* below this many values per thread, threads cost more than they save */
+constexpr std::size_t hist_min_chunk = 1 << 16;
+
+template<typename T>
+static void histogram_freq(Histogram *hist, const char *title,
+                           const T *values, std::size_t n_values,
+                           const T *thresholds, std::size_t n_thresholds,
+                           unsigned n_threads = 1)
+{
+    std::size_t *counts, i, c, n_counts;
+    unsigned n_chunks;
+    T *freeme = NULL;
+
+    if (!thresholds) {
+        thresholds = freeme = invent_thresholds(values, n_values,
+                                                &n_thresholds);
+    }
+
+    histogram_init(hist, title, n_thresholds);
+
+    n_chunks = parallel_chunks(n_threads, n_values, hist_min_chunk);
+    n_counts = n_chunks * hist_count_copies * hist->n_buckets;
+    counts = static_cast<std::size_t *>(statsutil_calloc(n_counts,
+                                                         sizeof(counts[0])));
+
+    if (counts) {
+        hist_count_ctx<T> ctx = {
+            .bucketer = hist_bucketer_for(thresholds, n_thresholds),
+            .values = values,
+            .counts = counts,
+        };
+
+        if (n_chunks > 1)
+            parallel_for(n_threads, n_values, hist_min_chunk,
+                         &histogram_count_chunk<T>, &ctx);
+        else
+            histogram_count(ctx.bucketer, values, n_values, counts);
+
+        for (c = 0; c < n_chunks * hist_count_copies; c++) {
+            for (i = 0; i < hist->n_buckets; i++)
+                hist->buckets[i].freq_raw += counts[c * hist->n_buckets + i];
+        }
+        statsutil_free(counts);
+    }
+    else {
+        const hist_bucketer<T> b = { thresholds, n_thresholds, 0.0, 0.0,
+                                     HIST_LINEAR };
+
+        for (i = 0; i < n_values; i++)
+            hist->buckets[b.linear(values[i])].freq_raw ++;
+    }
+
+    histogram_finish(hist, thresholds, n_thresholds, n_values);
+    statsutil_free(freeme);
+}
+
+/* a qsketch counts |x| in bucket k = ceil(log_gamma |x|), for gamma =
+ * (1 + alpha) / (1 - alpha), and reports it as 2 gamma^k / (gamma + 1),
+ * which is within alpha of everything in the bucket
+ */
+constexpr int64_t qsketch_slack = 64;
+
+struct qsketch_header {
+    char magic[4];
+    uint32_t version;
+    double alpha;
+    uint64_t max_buckets;
+    uint64_t n_values;
+    uint64_t n_zero;
+    double min, max;
+    int32_t neg_offset;
+    uint32_t neg_n_buckets;
+    int32_t pos_offset;
+    uint32_t pos_n_buckets;
+};
+
+static const char qsketch_magic[4] = { 'F', 'Q', 'S', 'K' };
+
+static inline int32_t qsketch_key(const struct qsketch *qs, double x)
+{
+    /* infinities are counted with the greatest finite magnitude */
+    x = std::min(x, std::numeric_limits<double>::max());
+
+    return statsutil_ceil(statsutil_log(x) / qs->ln_gamma);
+}
+
+/* the value reported for bucket key of the given sign, kept within the
+ * exact min and max */
+static inline double qsketch_value(const struct qsketch *qs,
+                                   int64_t key, double sign)
+{
+    const double v = 2.0 * statsutil_exp(key * qs->ln_gamma)
+                     / (1.0 + statsutil_exp(qs->ln_gamma));
+
+    return std::clamp(sign * v, qs->min, qs->max);
+}
+
+/* grows st to cover keys lo to hi, with some slack in the direction it
+ * grew, keeping at most max_buckets by folding the lowest keys into the
+ * lowest one kept
+ */
+static bool qsketch_cover(struct qsketch_store *st, std::size_t max_buckets,
+                          int32_t lo, int32_t hi)
+{
+    int64_t new_lo = lo, new_hi = hi;
+    std::size_t *counts, i, n_buckets;
+
+    if (st->n_buckets) {
+        const int64_t st_hi = st->offset + (int64_t) st->n_buckets - 1;
+
+        if (lo >= st->offset && hi <= st_hi) return true;
+
+        new_lo = std::min<int64_t>(lo, st->offset);
+        new_hi = std::max<int64_t>(hi, st_hi);
+    }
+
+    if (new_hi - new_lo + 1 > (int64_t) max_buckets) {
+        /* fold only the keys that can't fit below the highest */
+        new_lo = new_hi - (int64_t) max_buckets + 1;
+    }
+    else if (st->n_buckets) {
+        /* leave slack on the growing sides, as far as max_buckets allows */
+        int64_t room = max_buckets - (new_hi - new_lo + 1), slack;
+
+        if (new_hi > st->offset + (int64_t) st->n_buckets - 1) {
+            slack = std::min(qsketch_slack, room);
+            new_hi += slack;
+            room -= slack;
+        }
+        if (new_lo < st->offset)
+            new_lo -= std::min(qsketch_slack, room);
+    }
+
+    if (st->n_buckets && new_lo == st->offset
+        && new_hi == st->offset + (int64_t) st->n_buckets - 1)
+        return true;
+
+    n_buckets = new_hi - new_lo + 1;
+    counts = static_cast<std::size_t *>(statsutil_calloc(n_buckets,
+                                                         sizeof(counts[0])));
+    if (!counts) return false;
+
+    for (i = 0; i < st->n_buckets; i++) {
+        const int64_t key = std::max<int64_t>(st->offset + i, new_lo);
+
+        counts[key - new_lo] += st->counts[i];
+    }
+
+    statsutil_free(st->counts);
+    st->counts = counts;
+    st->n_buckets = n_buckets;
+    st->offset = new_lo;
+    return true;
+}
+
+/* adds count at key, which st must cover or have folded away */
+static inline void qsketch_add(struct qsketch_store *st,
+                               int64_t key, std::size_t count)
+{
+    st->counts[std::max<int64_t>(key, st->offset) - st->offset] += count;
+}
+
+static inline void qsketch_extremes(struct qsketch *qs,
+                                    double min, double max, std::size_t n)
+{
+    if (!qs->n_values) {
+        qs->min = min;
+        qs->max = max;
+    }
+    else {
+        qs->min = std::min(qs->min, min);
+        qs->max = std::max(qs->max, max);
+    }
+    qs->n_values += n;
+}
+
+/* calls f(value, count) for each non-empty bucket in order of value,
+ * until f returns true */
+template<typename F>
+static void qsketch_walk(const struct qsketch *qs, F f)
+{
+    std::size_t i;
+
+    for (i = qs->neg.n_buckets; i-- > 0; ) {
+        if (qs->neg.counts[i]
+            && f(qsketch_value(qs, qs->neg.offset + (int64_t) i, -1.0),
+                 qs->neg.counts[i]))
+            return;
+    }
+    if (qs->n_zero && f(0.0, qs->n_zero))
+        return;
+    for (i = 0; i < qs->pos.n_buckets; i++) {
+        if (qs->pos.counts[i]
+            && f(qsketch_value(qs, qs->pos.offset + (int64_t) i, 1.0),
+                 qs->pos.counts[i]))
+            return;
+    }
+}
+
+/* a sketch's values in order, as summary7_sorted() wants them */
+struct sketched_values {
+    const struct qsketch *qs;
+
+    double operator[](std::size_t k) const
+    {
+        double x = qs->max;
+
+        if (k == 0) return qs->min;
+        if (k >= qs->n_values - 1) return qs->max;
+
+        qsketch_walk(qs, [&](double v, std::size_t count) {
+            if (k < count) {
+                x = v;
+                return true;
+            }
+            k -= count;
+            return false;
+        });
+        return x;
+    }
+
+    /* how many values are below x */
+    std::size_t n_below(double x) const
+    {
+        std::size_t n = 0;
+
+        qsketch_walk(qs, [&](double v, std::size_t count) {
+            if (!(v < x)) return true;
+            n += count;
+            return false;
+        });
+        return n;
+    }
+
+    /* how many values are at or below x */
+    std::size_t n_not_above(double x) const
+    {
+        std::size_t n = 0;
+
+        qsketch_walk(qs, [&](double v, std::size_t count) {
+            if (v > x) return true;
+            n += count;
+            return false;
+        });
+        return n;
+    }
+};
+
+static unsigned char *qsketch_write_store(unsigned char *p,
+                                          const struct qsketch_store *st)
+{
+    std::size_t i;
+
+    for (i = 0; i < st->n_buckets; i++) {
+        const uint64_t count = st->counts[i];
+
+        __builtin_memcpy(p, &count, sizeof(count));
+        p += sizeof(count);
+    }
+    return p;
+}
+
+static const unsigned char *qsketch_read_store(const unsigned char *p,
+                                               struct qsketch_store *st,
+                                               int32_t offset,
+                                               std::size_t n_buckets,
+                                               std::size_t *ptotal)
+{
+    std::size_t i;
+
+    if (!n_buckets) return p;
+
+    st->counts = static_cast<std::size_t *>(
+        statsutil_calloc(n_buckets, sizeof(st->counts[0])));
+    if (!st->counts) return NULL;
+    st->n_buckets = n_buckets;
+    st->offset = offset;
+
+    for (i = 0; i < n_buckets; i++) {
+        uint64_t count;
+
+        __builtin_memcpy(&count, p, sizeof(count));
+        p += sizeof(count);
+        st->counts[i] = count;
+        *ptotal += count;
+    }
+    return p;
+}
+
+/* lowest value counted in bucket i of an hdrhist: bucket i holds values
+ * with i = (shift << sub_bits) + (value >> shift), and the first 2 <<
+ * sub_bits buckets have a shift of 0
+ */
+static inline uint64_t hdrhist_bucket_lb(const struct hdrhist *h,
+                                         std::size_t i, unsigned *pshift)
+{
+    const std::size_t hi = i >> h->sub_bits;
+    const unsigned shift = hi ? hi - 1 : 0;
+
+    *pshift = shift;
+    return static_cast<uint64_t>(i - ((std::size_t) shift << h->sub_bits))
+           << shift;
+}
+
+/* the value reported for bucket i, its midpoint kept within min and max */
+static inline double hdrhist_value(const struct hdrhist *h, std::size_t i)
+{
+    unsigned shift;
+    const double lb = hdrhist_bucket_lb(h, i, &shift);
+    const double v = lb + 0.5 * ((UINT64_C(1) << shift) - 1);
+
+    return std::clamp(v, (double) h->min, (double) h->max);
+}
+
+/* calls f(value, count) for each non-empty bucket in order, until f
+ * returns true */
+template<typename F>
+static void hdrhist_walk(const struct hdrhist *h, F f)
+{
+    std::size_t i;
+
+    for (i = 0; i < h->n_counts; i++) {
+        if (h->counts[i] && f(hdrhist_value(h, i), h->counts[i]))
+            return;
+    }
+}
+
+/* an hdrhist's values in order, as summary7_sorted() wants them */
+struct hdrhist_values {
+    const struct hdrhist *h;
+
+    double operator[](std::size_t k) const
+    {
+        double x = h->max;
+
+        if (k == 0) return h->min;
+        if (k >= h->n_values - 1) return h->max;
+
+        hdrhist_walk(h, [&](double v, std::size_t count) {
+            if (k < count) {
+                x = v;
+                return true;
+            }
+            k -= count;
+            return false;
+        });
+        return x;
+    }
+
+    /* how many values are below x */
+    std::size_t n_below(double x) const
+    {
+        std::size_t n = 0;
+
+        hdrhist_walk(h, [&](double v, std::size_t count) {
+            if (!(v < x)) return true;
+            n += count;
+            return false;
+        });
+        return n;
+    }
+
+    /* how many values are at or below x */
+    std::size_t n_not_above(double x) const
+    {
+        std::size_t n = 0;
+
+        hdrhist_walk(h, [&](double v, std::size_t count) {
+            if (v > x) return true;
+            n += count;
+            return false;
+        });
+        return n;
+    }
+};
+
+extern "C" {
+static int find_max_value(const HashMap *hm __attribute__((unused)),
+                          const void *key,
+                          size_t key_len __attribute__((unused)),
+                          void *value,
+                          void *ctx)
+{
+    struct fmv_ctx *fmv_ctx = static_cast<struct fmv_ctx *>(ctx);
+
+    if (value > fmv_ctx->max_value) {
+        fmv_ctx->max_key = key;
+        fmv_ctx->max_value = value;
+    }
+
+    return 0;
+}
+
+static int hashmap_incr(const HashMap *hm __attribute__((unused)),
+                        const void *key __attribute__((unused)),
+                        size_t key_len __attribute__((unused)),
+                        void **value,
+                        void *ctx __attribute__((unused)))
+{
+    uintptr_t v;
+
+    v = *reinterpret_cast<uintptr_t *>(value);
+    v++;
+    *value = reinterpret_cast<void *>(v);
+
+    return HASHMAP_OK;
+}
+
+double meani8v(const int8_t *values, size_t n_values)
+{
+    return mean(values, n_values);
+}
+
+double mediani8v(const int8_t *values, size_t n_values)
+{
+    return median(values, n_values);
+}
+
+int8_t modei8v(const int8_t *values, size_t n_values, size_t *pfrequency)
+{
+    return mode(values, n_values, pfrequency);
+}
+
+double variancei8v(const int8_t *values, size_t n_values, double mean)
+{
+    return variance(values, n_values, mean);
+}
+
+double meanu8v(const uint8_t *values, size_t n_values)
+{
+    return mean(values, n_values);
+}
+
+double medianu8v(const uint8_t *values, size_t n_values)
+{
+    return median(values, n_values);
+}
+
+uint8_t modeu8v(const uint8_t *values, size_t n_values, size_t *pfrequency)
+{
+    return mode(values, n_values, pfrequency);
+}
+
+double varianceu8v(const uint8_t *values, size_t n_values, double mean)
+{
+    return variance(values, n_values, mean);
+}
+
+double meani16v(const int16_t *values, size_t n_values)
+{
+    return mean(values, n_values);
+}
+
+double mediani16v(const int16_t *values, size_t n_values)
+{
+    return median(values, n_values);
+}
+
+int16_t modei16v(const int16_t *values, size_t n_values, size_t *pfrequency)
+{
+    return mode(values, n_values, pfrequency);
+}
+
+double variancei16v(const int16_t *values, size_t n_values, double mean)
+{
+    return variance(values, n_values, mean);
+}
+
+double meanu16v(const uint16_t *values, size_t n_values)
+{
+    return mean(values, n_values);
+}
+
+double medianu16v(const uint16_t *values, size_t n_values)
+{
+    return median(values, n_values);
+}
+
+uint16_t modeu16v(const uint16_t *values, size_t n_values, size_t *pfrequency)
+{
+    return mode(values, n_values, pfrequency);
+}
+
+double varianceu16v(const uint16_t *values, size_t n_values, double mean)
+{
+    return variance(values, n_values, mean);
+}
+
+double meani32v(const int32_t *values, size_t n_values)
+{
+    return mean(values, n_values);
+}
+
+double mediani32v(const int32_t *values, size_t n_values)
+{
+    return median(values, n_values);
+}
+
+int32_t modei32v(const int32_t *values, size_t n_values, size_t *pfrequency)
+{
+    return mode(values, n_values, pfrequency);
+}
+
+double variancei32v(const int32_t *values, size_t n_values, double mean)
+{
+    return variance(values, n_values, mean);
+}
+
+double meanu32v(const uint32_t *values, size_t n_values)
+{
+    return mean(values, n_values);
+}
+
+double medianu32v(const uint32_t *values, size_t n_values)
+{
+    return median(values, n_values);
+}
+
+uint32_t modeu32v(const uint32_t *values, size_t n_values, size_t *pfrequency)
+{
+    return mode(values, n_values, pfrequency);
+}
+
+double varianceu32v(const uint32_t *values, size_t n_values, double mean)
+{
+    return variance(values, n_values, mean);
+}
+
+double meani64v(const int64_t *values, size_t n_values)
+{
+    return mean(values, n_values);
+}
+
+double mediani64v(const int64_t *values, size_t n_values)
+{
+    return median(values, n_values);
+}
+
+int64_t modei64v(const int64_t *values, size_t n_values, size_t *pfrequency)
+{
+    return mode(values, n_values, pfrequency);
+}
+
+double variancei64v(const int64_t *values, size_t n_values, double mean)
+{
+    return variance(values, n_values, mean);
+}
+
+double meanu64v(const uint64_t *values, size_t n_values)
+{
+    return mean(values, n_values);
+}
+
+double medianu64v(const uint64_t *values, size_t n_values)
+{
+    return median(values, n_values);
+}
+
+uint64_t modeu64v(const uint64_t *values, size_t n_values, size_t *pfrequency)
+{
+    return mode(values, n_values, pfrequency);
+}
+
+double varianceu64v(const uint64_t *values, size_t n_values, double mean)
+{
+    return variance(values, n_values, mean);
+}
+
+double meanf32v(const float *values, size_t n_values)
+{
+    return mean(values, n_values);
+}
+
+double medianf32v(const float *values, size_t n_values)
+{
+    return median(values, n_values);
+}
+
+double variancef32v(const float *values, size_t n_values, double mean)
+{
+    return variance(values, n_values, mean);
+}
+
+double meanf64v(const double *values, size_t n_values)
+{
+    return mean(values, n_values);
+}
+
+double medianf64v(const double *values, size_t n_values)
+{
+    return median(values, n_values);
+}
+
+double variancef64v(const double *values, size_t n_values, double mean)
+{
+    return variance(values, n_values, mean);
+}
+
+void statsi8v(const int8_t *values, size_t n_values,
+              int8_t *pmin, size_t *pmin_frequency,
+              int8_t *pmax, size_t *pmax_frequency,
+              double *pmean, double *pvariance)
+{
+    return stats(values, n_values,
+                 pmin, pmin_frequency,
+                 pmax, pmax_frequency,
+                 pmean, pvariance);
+}
+
+void statsu8v(const uint8_t *values, size_t n_values,
+              uint8_t *pmin, size_t *pmin_frequency,
+              uint8_t *pmax, size_t *pmax_frequency,
+              double *pmean, double *pvariance)
+{
+    return stats(values, n_values,
+                 pmin, pmin_frequency,
+                 pmax, pmax_frequency,
+                 pmean, pvariance);
+}
+
+void statsi16v(const int16_t *values, size_t n_values,
+               int16_t *pmin, size_t *pmin_frequency,
+               int16_t *pmax, size_t *pmax_frequency,
+               double *pmean, double *pvariance)
+{
+    return stats(values, n_values,
+                 pmin, pmin_frequency,
+                 pmax, pmax_frequency,
+                 pmean, pvariance);
+}
+
+void statsu16v(const uint16_t *values, size_t n_values,
+               uint16_t *pmin, size_t *pmin_frequency,
+               uint16_t *pmax, size_t *pmax_frequency,
+               double *pmean, double *pvariance)
+{
+    return stats(values, n_values,
+                 pmin, pmin_frequency,
+                 pmax, pmax_frequency,
+                 pmean, pvariance);
+}
+
+void statsi32v(const int32_t *values, size_t n_values,
+               int32_t *pmin, size_t *pmin_frequency,
+               int32_t *pmax, size_t *pmax_frequency,
+               double *pmean, double *pvariance)
+{
+    return stats(values, n_values,
+                 pmin, pmin_frequency,
+                 pmax, pmax_frequency,
+                 pmean, pvariance);
+}
+
+void statsu32v(const uint32_t *values, size_t n_values,
+               uint32_t *pmin, size_t *pmin_frequency,
+               uint32_t *pmax, size_t *pmax_frequency,
+               double *pmean, double *pvariance)
+{
+    return stats(values, n_values,
+                 pmin, pmin_frequency,
+                 pmax, pmax_frequency,
+                 pmean, pvariance);
+}
+
+void statsi64v(const int64_t *values, size_t n_values,
+               int64_t *pmin, size_t *pmin_frequency,
+               int64_t *pmax, size_t *pmax_frequency,
+               double *pmean, double *pvariance)
+{
+    return stats(values, n_values,
+                 pmin, pmin_frequency,
+                 pmax, pmax_frequency,
+                 pmean, pvariance);
+}
+
+void statsu64v(const uint64_t *values, size_t n_values,
+               uint64_t *pmin, size_t *pmin_frequency,
+               uint64_t *pmax, size_t *pmax_frequency,
+               double *pmean, double *pvariance)
+{
+    return stats(values, n_values,
+                 pmin, pmin_frequency,
+                 pmax, pmax_frequency,
+                 pmean, pvariance);
+}
+
+void statsf32v(const float *values, size_t n_values,
+               float *pmin, size_t *pmin_frequency,
+               float *pmax, size_t *pmax_frequency,
+               double *pmean, double *pvariance)
+{
+    return stats(values, n_values,
+                 pmin, pmin_frequency,
+                 pmax, pmax_frequency,
+                 pmean, pvariance);
+}
+
+void statsf64v(const double *values, size_t n_values,
+               double *pmin, size_t *pmin_frequency,
+               double *pmax, size_t *pmax_frequency,
+               double *pmean, double *pvariance)
+{
+    return stats(values, n_values,
+                 pmin, pmin_frequency,
+                 pmax, pmax_frequency,
+                 pmean, pvariance);
+}
+
+double meani8v_parallel(const int8_t *values, size_t n_values,
+                        unsigned n_threads)
+{
+    return mean_parallel(values, n_values, n_threads);
+}
+
+double mediani8v_parallel(const int8_t *values, size_t n_values,
+                          unsigned n_threads)
+{
+    return median(values, n_values, n_threads);
+}
+
+int8_t modei8v_parallel(const int8_t *values, size_t n_values,
+                        size_t *pfrequency, unsigned n_threads)
+{
+    return mode_parallel(values, n_values, pfrequency, n_threads);
+}
+
+double variancei8v_parallel(const int8_t *values, size_t n_values,
+                            double mean, unsigned n_threads)
+{
+    return variance_parallel(values, n_values, mean, n_threads);
+}
+
+void statsi8v_parallel(const int8_t *values, size_t n_values,
+                       int8_t *pmin, size_t *pmin_frequency,
+                       int8_t *pmax, size_t *pmax_frequency,
+                       double *pmean, double *pvariance,
+                       unsigned n_threads)
+{
+    stats_parallel(values, n_values,
+                   pmin, pmin_frequency,
+                   pmax, pmax_frequency,
+                   pmean, pvariance, n_threads);
+}
+
+double meanu8v_parallel(const uint8_t *values, size_t n_values,
+                        unsigned n_threads)
+{
+    return mean_parallel(values, n_values, n_threads);
+}
+
+double medianu8v_parallel(const uint8_t *values, size_t n_values,
+                          unsigned n_threads)
+{
+    return median(values, n_values, n_threads);
+}
+
+uint8_t modeu8v_parallel(const uint8_t *values, size_t n_values,
+                         size_t *pfrequency, unsigned n_threads)
+{
+    return mode_parallel(values, n_values, pfrequency, n_threads);
+}
+
+double varianceu8v_parallel(const uint8_t *values, size_t n_values,
+                            double mean, unsigned n_threads)
+{
+    return variance_parallel(values, n_values, mean, n_threads);
+}
+
+void statsu8v_parallel(const uint8_t *values, size_t n_values,
+                       uint8_t *pmin, size_t *pmin_frequency,
+                       uint8_t *pmax, size_t *pmax_frequency,
+                       double *pmean, double *pvariance,
+                       unsigned n_threads)
+{
+    stats_parallel(values, n_values,
+                   pmin, pmin_frequency,
+                   pmax, pmax_frequency,
+                   pmean, pvariance, n_threads);
+}
+
+double meani16v_parallel(const int16_t *values, size_t n_values,
+                         unsigned n_threads)
+{
+    return mean_parallel(values, n_values, n_threads);
+}
+
+double mediani16v_parallel(const int16_t *values, size_t n_values,
+                           unsigned n_threads)
+{
+    return median(values, n_values, n_threads);
+}
+
+int16_t modei16v_parallel(const int16_t *values, size_t n_values,
+                          size_t *pfrequency, unsigned n_threads)
+{
+    return mode_parallel(values, n_values, pfrequency, n_threads);
+}
+
+double variancei16v_parallel(const int16_t *values, size_t n_values,
+                             double mean, unsigned n_threads)
+{
+    return variance_parallel(values, n_values, mean, n_threads);
+}
+
+void statsi16v_parallel(const int16_t *values, size_t n_values,
+                        int16_t *pmin, size_t *pmin_frequency,
+                        int16_t *pmax, size_t *pmax_frequency,
+                        double *pmean, double *pvariance,
+                        unsigned n_threads)
+{
+    stats_parallel(values, n_values,
+                   pmin, pmin_frequency,
+                   pmax, pmax_frequency,
+                   pmean, pvariance, n_threads);
+}
+
+double meanu16v_parallel(const uint16_t *values, size_t n_values,
+                         unsigned n_threads)
+{
+    return mean_parallel(values, n_values, n_threads);
+}
+
+double medianu16v_parallel(const uint16_t *values, size_t n_values,
+                           unsigned n_threads)
+{
+    return median(values, n_values, n_threads);
+}
+
+uint16_t modeu16v_parallel(const uint16_t *values, size_t n_values,
+                           size_t *pfrequency, unsigned n_threads)
+{
+    return mode_parallel(values, n_values, pfrequency, n_threads);
+}
+
+double varianceu16v_parallel(const uint16_t *values, size_t n_values,
+                             double mean, unsigned n_threads)
+{
+    return variance_parallel(values, n_values, mean, n_threads);
+}
+
+void statsu16v_parallel(const uint16_t *values, size_t n_values,
+                        uint16_t *pmin, size_t *pmin_frequency,
+                        uint16_t *pmax, size_t *pmax_frequency,
+                        double *pmean, double *pvariance,
+                        unsigned n_threads)
+{
+    stats_parallel(values, n_values,
+                   pmin, pmin_frequency,
+                   pmax, pmax_frequency,
+                   pmean, pvariance, n_threads);
+}
+
+double meani32v_parallel(const int32_t *values, size_t n_values,
+                         unsigned n_threads)
+{
+    return mean_parallel(values, n_values, n_threads);
+}
+
+double mediani32v_parallel(const int32_t *values, size_t n_values,
+                           unsigned n_threads)
+{
+    return median(values, n_values, n_threads);
+}
+
+int32_t modei32v_parallel(const int32_t *values, size_t n_values,
+                          size_t *pfrequency, unsigned n_threads)
+{
+    return mode_parallel(values, n_values, pfrequency, n_threads);
+}
+
+double variancei32v_parallel(const int32_t *values, size_t n_values,
+                             double mean, unsigned n_threads)
+{
+    return variance_parallel(values, n_values, mean, n_threads);
+}
+
+void statsi32v_parallel(const int32_t *values, size_t n_values,
+                        int32_t *pmin, size_t *pmin_frequency,
+                        int32_t *pmax, size_t *pmax_frequency,
+                        double *pmean, double *pvariance,
+                        unsigned n_threads)
+{
+    stats_parallel(values, n_values,
+                   pmin, pmin_frequency,
+                   pmax, pmax_frequency,
+                   pmean, pvariance, n_threads);
+}
+
+double meanu32v_parallel(const uint32_t *values, size_t n_values,
+                         unsigned n_threads)
+{
+    return mean_parallel(values, n_values, n_threads);
+}
+
+double medianu32v_parallel(const uint32_t *values, size_t n_values,
+                           unsigned n_threads)
+{
+    return median(values, n_values, n_threads);
+}
+
+uint32_t modeu32v_parallel(const uint32_t *values, size_t n_values,
+                           size_t *pfrequency, unsigned n_threads)
+{
+    return mode_parallel(values, n_values, pfrequency, n_threads);
+}
+
+double varianceu32v_parallel(const uint32_t *values, size_t n_values,
+                             double mean, unsigned n_threads)
+{
+    return variance_parallel(values, n_values, mean, n_threads);
+}
+
+void statsu32v_parallel(const uint32_t *values, size_t n_values,
+                        uint32_t *pmin, size_t *pmin_frequency,
+                        uint32_t *pmax, size_t *pmax_frequency,
+                        double *pmean, double *pvariance,
+                        unsigned n_threads)
+{
+    stats_parallel(values, n_values,
+                   pmin, pmin_frequency,
+                   pmax, pmax_frequency,
+                   pmean, pvariance, n_threads);
+}
+
+double meani64v_parallel(const int64_t *values, size_t n_values,
+                         unsigned n_threads)
+{
+    return mean_parallel(values, n_values, n_threads);
+}
+
+double mediani64v_parallel(const int64_t *values, size_t n_values,
+                           unsigned n_threads)
+{
+    return median(values, n_values, n_threads);
+}
+
+int64_t modei64v_parallel(const int64_t *values, size_t n_values,
+                          size_t *pfrequency, unsigned n_threads)
+{
+    return mode_parallel(values, n_values, pfrequency, n_threads);
+}
+
+double variancei64v_parallel(const int64_t *values, size_t n_values,
+                             double mean, unsigned n_threads)
+{
+    return variance_parallel(values, n_values, mean, n_threads);
+}
+
+void statsi64v_parallel(const int64_t *values, size_t n_values,
+                        int64_t *pmin, size_t *pmin_frequency,
+                        int64_t *pmax, size_t *pmax_frequency,
+                        double *pmean, double *pvariance,
+                        unsigned n_threads)
+{
+    stats_parallel(values, n_values,
+                   pmin, pmin_frequency,
+                   pmax, pmax_frequency,
+                   pmean, pvariance, n_threads);
+}
+
+double meanu64v_parallel(const uint64_t *values, size_t n_values,
+                         unsigned n_threads)
+{
+    return mean_parallel(values, n_values, n_threads);
+}
+
+double medianu64v_parallel(const uint64_t *values, size_t n_values,
+                           unsigned n_threads)
+{
+    return median(values, n_values, n_threads);
+}
+
+uint64_t modeu64v_parallel(const uint64_t *values, size_t n_values,
+                           size_t *pfrequency, unsigned n_threads)
+{
+    return mode_parallel(values, n_values, pfrequency, n_threads);
+}
+
+double varianceu64v_parallel(const uint64_t *values, size_t n_values,
+                             double mean, unsigned n_threads)
+{
+    return variance_parallel(values, n_values, mean, n_threads);
+}
+
+void statsu64v_parallel(const uint64_t *values, size_t n_values,
+                        uint64_t *pmin, size_t *pmin_frequency,
+                        uint64_t *pmax, size_t *pmax_frequency,
+                        double *pmean, double *pvariance,
+                        unsigned n_threads)
+{
+    stats_parallel(values, n_values,
+                   pmin, pmin_frequency,
+                   pmax, pmax_frequency,
+                   pmean, pvariance, n_threads);
+}
+
+double meanf32v_parallel(const float *values, size_t n_values,
+                         unsigned n_threads)
+{
+    return mean_parallel(values, n_values, n_threads);
+}
+
+double medianf32v_parallel(const float *values, size_t n_values,
+                           unsigned n_threads)
+{
+    return median(values, n_values, n_threads);
+}
+
+double variancef32v_parallel(const float *values, size_t n_values,
+                             double mean, unsigned n_threads)
+{
+    return variance_parallel(values, n_values, mean, n_threads);
+}
+
+void statsf32v_parallel(const float *values, size_t n_values,
+                        float *pmin, size_t *pmin_frequency,
+                        float *pmax, size_t *pmax_frequency,
+                        double *pmean, double *pvariance,
+                        unsigned n_threads)
+{
+    stats_parallel(values, n_values,
+                   pmin, pmin_frequency,
+                   pmax, pmax_frequency,
+                   pmean, pvariance, n_threads);
+}
+
+double meanf64v_parallel(const double *values, size_t n_values,
+                         unsigned n_threads)
+{
+    return mean_parallel(values, n_values, n_threads);
+}
+
+double medianf64v_parallel(const double *values, size_t n_values,
+                           unsigned n_threads)
+{
+    return median(values, n_values, n_threads);
+}
+
+double variancef64v_parallel(const double *values, size_t n_values,
+                             double mean, unsigned n_threads)
+{
+    return variance_parallel(values, n_values, mean, n_threads);
+}
+
+void statsf64v_parallel(const double *values, size_t n_values,
+                        double *pmin, size_t *pmin_frequency,
+                        double *pmax, size_t *pmax_frequency,
+                        double *pmean, double *pvariance,
+                        unsigned n_threads)
+{
+    stats_parallel(values, n_values,
+                   pmin, pmin_frequency,
+                   pmax, pmax_frequency,
+                   pmean, pvariance, n_threads);
+}
+
+void stats_acc_pushi8(struct stats_acc *acc, int8_t value)
+{
+    stats_acc_push(acc, value);
+}
+
+void stats_acc_pushi8v(struct stats_acc *acc,
+                       const int8_t *values, size_t n_values)
+{
+    stats_acc_push(acc, values, n_values);
+}
+
+void stats_acc_mergei8(struct stats_acc *acc,
+                       const struct stats_acc *other)
+{
+    stats_acc_merge<int8_t>(acc, other);
+}
+
+void stats_acc_resulti8(const struct stats_acc *acc,
+                        int8_t *pmin, size_t *pmin_frequency,
+                        int8_t *pmax, size_t *pmax_frequency,
+                        double *pmean, double *pvariance)
+{
+    stats_acc_result(acc, pmin, pmin_frequency, pmax, pmax_frequency,
+                     pmean, pvariance);
+}
+
+void stats_acc_pushu8(struct stats_acc *acc, uint8_t value)
+{
+    stats_acc_push(acc, value);
+}
+
+void stats_acc_pushu8v(struct stats_acc *acc,
+                       const uint8_t *values, size_t n_values)
+{
+    stats_acc_push(acc, values, n_values);
+}
+
+void stats_acc_mergeu8(struct stats_acc *acc,
+                       const struct stats_acc *other)
+{
+    stats_acc_merge<uint8_t>(acc, other);
+}
+
+void stats_acc_resultu8(const struct stats_acc *acc,
+                        uint8_t *pmin, size_t *pmin_frequency,
+                        uint8_t *pmax, size_t *pmax_frequency,
+                        double *pmean, double *pvariance)
+{
+    stats_acc_result(acc, pmin, pmin_frequency, pmax, pmax_frequency,
+                     pmean, pvariance);
+}
+
+void stats_acc_pushi16(struct stats_acc *acc, int16_t value)
+{
+    stats_acc_push(acc, value);
+}
+
+void stats_acc_pushi16v(struct stats_acc *acc,
+                        const int16_t *values, size_t n_values)
+{
+    stats_acc_push(acc, values, n_values);
+}
+
+void stats_acc_mergei16(struct stats_acc *acc,
+                        const struct stats_acc *other)
+{
+    stats_acc_merge<int16_t>(acc, other);
+}
+
+void stats_acc_resulti16(const struct stats_acc *acc,
+                         int16_t *pmin, size_t *pmin_frequency,
+                         int16_t *pmax, size_t *pmax_frequency,
+                         double *pmean, double *pvariance)
+{
+    stats_acc_result(acc, pmin, pmin_frequency, pmax, pmax_frequency,
+                     pmean, pvariance);
+}
+
+void stats_acc_pushu16(struct stats_acc *acc, uint16_t value)
+{
+    stats_acc_push(acc, value);
+}
+
+void stats_acc_pushu16v(struct stats_acc *acc,
+                        const uint16_t *values, size_t n_values)
+{
+    stats_acc_push(acc, values, n_values);
+}
+
+void stats_acc_mergeu16(struct stats_acc *acc,
+                        const struct stats_acc *other)
+{
+    stats_acc_merge<uint16_t>(acc, other);
+}
+
+void stats_acc_resultu16(const struct stats_acc *acc,
+                         uint16_t *pmin, size_t *pmin_frequency,
+                         uint16_t *pmax, size_t *pmax_frequency,
+                         double *pmean, double *pvariance)
+{
+    stats_acc_result(acc, pmin, pmin_frequency, pmax, pmax_frequency,
+                     pmean, pvariance);
+}
+
+void stats_acc_pushi32(struct stats_acc *acc, int32_t value)
+{
+    stats_acc_push(acc, value);
+}
+
+void stats_acc_pushi32v(struct stats_acc *acc,
+                        const int32_t *values, size_t n_values)
+{
+    stats_acc_push(acc, values, n_values);
+}
+
+void stats_acc_mergei32(struct stats_acc *acc,
+                        const struct stats_acc *other)
+{
+    stats_acc_merge<int32_t>(acc, other);
+}
 
-        n_thresholds = statsutil_ceil(t);
-    }
+void stats_acc_resulti32(const struct stats_acc *acc,
+                         int32_t *pmin, size_t *pmin_frequency,
+                         int32_t *pmax, size_t *pmax_frequency,
+                         double *pmean, double *pvariance)
+{
+    stats_acc_result(acc, pmin, pmin_frequency, pmax, pmax_frequency,
+                     pmean, pvariance);
+}
 
-    if (std::is_floating_point_v<T>) {
-        step = niceceil(range / n_thresholds);
-    }
-    else {
-        n_thresholds = std::min(n_thresholds, (size_t) range);
-        step = statsutil_ceil(1.0 * range / n_thresholds);
-    }
+void stats_acc_pushu32(struct stats_acc *acc, uint32_t value)
+{
+    stats_acc_push(acc, value);
+}
 
-    thresholds = (T*) statsutil_malloc(n_thresholds * sizeof(thresholds[0]));
-    if (!thresholds) return NULL;
+void stats_acc_pushu32v(struct stats_acc *acc,
+                        const uint32_t *values, size_t n_values)
+{
+    stats_acc_push(acc, values, n_values);
+}
 
-    if (lb == std::numeric_limits<T>::lowest())
-        lb += step;
-    for (i = 0; i < n_thresholds; i++) {
-        thresholds[i] = i * step + lb;
-    }
+void stats_acc_mergeu32(struct stats_acc *acc,
+                        const struct stats_acc *other)
+{
+    stats_acc_merge<uint32_t>(acc, other);
+}
 
-    *pn_thresholds = n_thresholds;
-    return thresholds;
+void stats_acc_resultu32(const struct stats_acc *acc,
+                         uint32_t *pmin, size_t *pmin_frequency,
+                         uint32_t *pmax, size_t *pmax_frequency,
+                         double *pmean, double *pvariance)
+{
+    stats_acc_result(acc, pmin, pmin_frequency, pmax, pmax_frequency,
+                     pmean, pvariance);
 }
 
-template<typename T>
-static void histogram_freq(Histogram *hist, const char *title,
-                           const T *values, std::size_t n_values,
-                           const T *thresholds, std::size_t n_thresholds)
+void stats_acc_pushi64(struct stats_acc *acc, int64_t value)
 {
-    std::size_t min_freq_raw = std::numeric_limits<std::size_t>::max();
-    std::size_t max_freq_raw = 0;
-    std::size_t i, t;
-    double fpp;
-    T *freeme = NULL;
+    stats_acc_push(acc, value);
+}
 
-    if (!thresholds) {
-        thresholds = freeme = invent_thresholds(values, n_values,
-                                                &n_thresholds);
-    }
+void stats_acc_pushi64v(struct stats_acc *acc,
+                        const int64_t *values, size_t n_values)
+{
+    stats_acc_push(acc, values, n_values);
+}
 
-    memset(hist, 0, sizeof(*hist));
-    hist->title = statsutil_strdup(title);
-    hist->n_buckets = n_thresholds + 1;
-    hist->buckets = (hist_bucket *) statsutil_calloc(hist->n_buckets,
-                                                     sizeof(hist->buckets[0]));
+void stats_acc_mergei64(struct stats_acc *acc,
+                        const struct stats_acc *other)
+{
+    stats_acc_merge<int64_t>(acc, other);
+}
 
-    /* count raw frequencies */
-    for (i = 0; i < n_values; i++) {
-        for (t = 0; t < n_thresholds; t++) {
-            if (values[i] < thresholds[t]) {
-                hist->buckets[t].freq_raw ++;
-                break;
-            }
-        }
-        if (t == n_thresholds)
-            hist->buckets[t].freq_raw ++;
-    }
+void stats_acc_resulti64(const struct stats_acc *acc,
+                         int64_t *pmin, size_t *pmin_frequency,
+                         int64_t *pmax, size_t *pmax_frequency,
+                         double *pmean, double *pvariance)
+{
+    stats_acc_result(acc, pmin, pmin_frequency, pmax, pmax_frequency,
+                     pmean, pvariance);
+}
 
-    /* compute percent frequencies, min/max raw frequency, and labels */
-    for (i = 0; i < hist->n_buckets; i++) {
-        struct hist_bucket *bucket = &hist->buckets[i];
+void stats_acc_pushu64(struct stats_acc *acc, uint64_t value)
+{
+    stats_acc_push(acc, value);
+}
 
-        bucket->freq_pc = 100.0 * bucket->freq_raw / n_values;
-        min_freq_raw = std::min(min_freq_raw, bucket->freq_raw);
-        max_freq_raw = std::max(max_freq_raw, bucket->freq_raw);
+void stats_acc_pushu64v(struct stats_acc *acc,
+                        const uint64_t *values, size_t n_values)
+{
+    stats_acc_push(acc, values, n_values);
+}
 
-        bucket->skip_if_zero = false;
+void stats_acc_mergeu64(struct stats_acc *acc,
+                        const struct stats_acc *other)
+{
+    stats_acc_merge<uint64_t>(acc, other);
+}
 
-        if (i == 0) {
-            if (std::numeric_limits<T>::is_signed)
-                strcpy(bucket->lb_label, "-inf");
-            else
-                strcpy(bucket->lb_label, "0");
-            bucket->skip_if_zero = true;
-        }
-        else {
-            snprintf(bucket->lb_label, sizeof(bucket->lb_label),
-                     "%g", (double) thresholds[i - 1]);
-        }
+void stats_acc_resultu64(const struct stats_acc *acc,
+                         uint64_t *pmin, size_t *pmin_frequency,
+                         uint64_t *pmax, size_t *pmax_frequency,
+                         double *pmean, double *pvariance)
+{
+    stats_acc_result(acc, pmin, pmin_frequency, pmax, pmax_frequency,
+                     pmean, pvariance);
+}
 
-        if (i == n_thresholds) {
-            strcpy(bucket->ub_label, "+inf");
-            bucket->skip_if_zero = true;
-        }
-        else {
-            snprintf(bucket->ub_label, sizeof(bucket->ub_label),
-                     "<%g", (double) thresholds[i]);
-        }
-    }
+void stats_acc_pushf32(struct stats_acc *acc, float value)
+{
+    stats_acc_push(acc, value);
+}
 
-    /* compute grid lines and pips */
-    fpp = niceceil(max_freq_raw / 60.0);
-    for (i = 0; i < 6; i++) {
-        hist->grid[i] = (i + 1) * fpp * 10.0;
-    }
-    for (i = 0; i < hist->n_buckets; i++) {
-        struct hist_bucket *bucket = &hist->buckets[i];
-        bucket->pips = statsutil_round(bucket->freq_raw / fpp);
-    }
+void stats_acc_pushf32v(struct stats_acc *acc,
+                        const float *values, size_t n_values)
+{
+    stats_acc_push(acc, values, n_values);
 }
 
-extern "C" {
-static int find_max_value(const HashMap *hm __attribute__((unused)),
-                          const void *key,
-                          size_t key_len __attribute__((unused)),
-                          void *value,
-                          void *ctx)
+void stats_acc_mergef32(struct stats_acc *acc,
+                        const struct stats_acc *other)
 {
-    struct fmv_ctx *fmv_ctx = static_cast<struct fmv_ctx *>(ctx);
+    stats_acc_merge<float>(acc, other);
+}
 
-    if (value > fmv_ctx->max_value) {
-        fmv_ctx->max_key = key;
-        fmv_ctx->max_value = value;
-    }
+void stats_acc_resultf32(const struct stats_acc *acc,
+                         float *pmin, size_t *pmin_frequency,
+                         float *pmax, size_t *pmax_frequency,
+                         double *pmean, double *pvariance)
+{
+    stats_acc_result(acc, pmin, pmin_frequency, pmax, pmax_frequency,
+                     pmean, pvariance);
+}
 
-    return 0;
+void stats_acc_pushf64(struct stats_acc *acc, double value)
+{
+    stats_acc_push(acc, value);
 }
 
-static int hashmap_incr(const HashMap *hm __attribute__((unused)),
-                        const void *key __attribute__((unused)),
-                        size_t key_len __attribute__((unused)),
-                        void **value,
-                        void *ctx __attribute__((unused)))
+void stats_acc_pushf64v(struct stats_acc *acc,
+                        const double *values, size_t n_values)
 {
-    uintptr_t v;
+    stats_acc_push(acc, values, n_values);
+}
 
-    v = *reinterpret_cast<uintptr_t *>(value);
-    v++;
-    *value = reinterpret_cast<void *>(v);
+void stats_acc_mergef64(struct stats_acc *acc,
+                        const struct stats_acc *other)
+{
+    stats_acc_merge<double>(acc, other);
+}
 
-    return HASHMAP_OK;
+void stats_acc_resultf64(const struct stats_acc *acc,
+                         double *pmin, size_t *pmin_frequency,
+                         double *pmax, size_t *pmax_frequency,
+                         double *pmean, double *pvariance)
+{
+    stats_acc_result(acc, pmin, pmin_frequency, pmax, pmax_frequency,
+                     pmean, pvariance);
 }
 
-double meani8v(const int8_t *values, size_t n_values)
+int summary7i8v(Summary7 *s7,
+                const int8_t *values, size_t n_values,
+                enum summary7_fence fence)
 {
-    return mean(values, n_values);
+    return summary7(s7, values, n_values, fence);
 }
 
-double mediani8v(const int8_t *values, size_t n_values)
+int summary7u8v(Summary7 *s7,
+                const uint8_t *values, size_t n_values,
+                enum summary7_fence fence)
 {
-    return median(values, n_values);
+    return summary7(s7, values, n_values, fence);
 }
 
-int8_t modei8v(const int8_t *values, size_t n_values, size_t *pfrequency)
+int summary7i16v(Summary7 *s7,
+                 const int16_t *values, size_t n_values,
+                 enum summary7_fence fence)
 {
-    return mode(values, n_values, pfrequency);
+    return summary7(s7, values, n_values, fence);
 }
 
-double variancei8v(const int8_t *values, size_t n_values, double mean)
+int summary7u16v(Summary7 *s7,
+                 const uint16_t *values, size_t n_values,
+                 enum summary7_fence fence)
 {
-    return variance(values, n_values, mean);
+    return summary7(s7, values, n_values, fence);
 }
 
-double meanu8v(const uint8_t *values, size_t n_values)
+int summary7i32v(Summary7 *s7,
+                 const int32_t *values, size_t n_values,
+                 enum summary7_fence fence)
 {
-    return mean(values, n_values);
+    return summary7(s7, values, n_values, fence);
 }
 
-double medianu8v(const uint8_t *values, size_t n_values)
+int summary7u32v(Summary7 *s7,
+                 const uint32_t *values, size_t n_values,
+                 enum summary7_fence fence)
 {
-    return median(values, n_values);
+    return summary7(s7, values, n_values, fence);
 }
 
-uint8_t modeu8v(const uint8_t *values, size_t n_values, size_t *pfrequency)
+int summary7i64v(Summary7 *s7,
+                 const int64_t *values, size_t n_values,
+                 enum summary7_fence fence)
 {
-    return mode(values, n_values, pfrequency);
+    return summary7(s7, values, n_values, fence);
 }
 
-double varianceu8v(const uint8_t *values, size_t n_values, double mean)
+int summary7u64v(Summary7 *s7,
+                 const uint64_t *values, size_t n_values,
+                 enum summary7_fence fence)
 {
-    return variance(values, n_values, mean);
+    return summary7(s7, values, n_values, fence);
 }
 
-double meani16v(const int16_t *values, size_t n_values)
+int summary7f32v(Summary7 *s7,
+                 const float *values, size_t n_values,
+                 enum summary7_fence fence)
 {
-    return mean(values, n_values);
+    return summary7(s7, values, n_values, fence);
 }
 
-double mediani16v(const int16_t *values, size_t n_values)
+int summary7f64v(Summary7 *s7,
+                 const double *values, size_t n_values,
+                 enum summary7_fence fence)
 {
-    return median(values, n_values);
+    return summary7(s7, values, n_values, fence);
 }
 
-int16_t modei16v(const int16_t *values, size_t n_values, size_t *pfrequency)
+int summary7i8v_parallel(Summary7 *s7,
+                         const int8_t *values, size_t n_values,
+                         enum summary7_fence fence,
+                         unsigned n_threads)
 {
-    return mode(values, n_values, pfrequency);
+    return summary7(s7, values, n_values, fence, n_threads);
 }
 
-double variancei16v(const int16_t *values, size_t n_values, double mean)
+int summary7u8v_parallel(Summary7 *s7,
+                         const uint8_t *values, size_t n_values,
+                         enum summary7_fence fence,
+                         unsigned n_threads)
 {
-    return variance(values, n_values, mean);
+    return summary7(s7, values, n_values, fence, n_threads);
 }
 
-double meanu16v(const uint16_t *values, size_t n_values)
+int summary7i16v_parallel(Summary7 *s7,
+                          const int16_t *values, size_t n_values,
+                          enum summary7_fence fence,
+                          unsigned n_threads)
 {
-    return mean(values, n_values);
+    return summary7(s7, values, n_values, fence, n_threads);
 }
 
-double medianu16v(const uint16_t *values, size_t n_values)
+int summary7u16v_parallel(Summary7 *s7,
+                          const uint16_t *values, size_t n_values,
+                          enum summary7_fence fence,
+                          unsigned n_threads)
 {
-    return median(values, n_values);
+    return summary7(s7, values, n_values, fence, n_threads);
 }
 
-uint16_t modeu16v(const uint16_t *values, size_t n_values, size_t *pfrequency)
+int summary7i32v_parallel(Summary7 *s7,
+                          const int32_t *values, size_t n_values,
+                          enum summary7_fence fence,
+                          unsigned n_threads)
 {
-    return mode(values, n_values, pfrequency);
+    return summary7(s7, values, n_values, fence, n_threads);
 }
 
-double varianceu16v(const uint16_t *values, size_t n_values, double mean)
+int summary7u32v_parallel(Summary7 *s7,
+                          const uint32_t *values, size_t n_values,
+                          enum summary7_fence fence,
+                          unsigned n_threads)
 {
-    return variance(values, n_values, mean);
+    return summary7(s7, values, n_values, fence, n_threads);
 }
 
-double meani32v(const int32_t *values, size_t n_values)
+int summary7i64v_parallel(Summary7 *s7,
+                          const int64_t *values, size_t n_values,
+                          enum summary7_fence fence,
+                          unsigned n_threads)
 {
-    return mean(values, n_values);
+    return summary7(s7, values, n_values, fence, n_threads);
 }
 
-double mediani32v(const int32_t *values, size_t n_values)
+int summary7u64v_parallel(Summary7 *s7,
+                          const uint64_t *values, size_t n_values,
+                          enum summary7_fence fence,
+                          unsigned n_threads)
 {
-    return median(values, n_values);
+    return summary7(s7, values, n_values, fence, n_threads);
 }
 
-int32_t modei32v(const int32_t *values, size_t n_values, size_t *pfrequency)
+int summary7f32v_parallel(Summary7 *s7,
+                          const float *values, size_t n_values,
+                          enum summary7_fence fence,
+                          unsigned n_threads)
 {
-    return mode(values, n_values, pfrequency);
+    return summary7(s7, values, n_values, fence, n_threads);
 }
 
-double variancei32v(const int32_t *values, size_t n_values, double mean)
+int summary7f64v_parallel(Summary7 *s7,
+                          const double *values, size_t n_values,
+                          enum summary7_fence fence,
+                          unsigned n_threads)
 {
-    return variance(values, n_values, mean);
+    return summary7(s7, values, n_values, fence, n_threads);
 }
 
-double meanu32v(const uint32_t *values, size_t n_values)
+double mediani8v_inplace(int8_t *values, size_t n_values)
 {
-    return mean(values, n_values);
+    return median_inplace(values, n_values);
 }
 
-double medianu32v(const uint32_t *values, size_t n_values)
+double medianu8v_inplace(uint8_t *values, size_t n_values)
 {
-    return median(values, n_values);
+    return median_inplace(values, n_values);
 }
 
-uint32_t modeu32v(const uint32_t *values, size_t n_values, size_t *pfrequency)
+double mediani16v_inplace(int16_t *values, size_t n_values)
 {
-    return mode(values, n_values, pfrequency);
+    return median_inplace(values, n_values);
 }
 
-double varianceu32v(const uint32_t *values, size_t n_values, double mean)
+double medianu16v_inplace(uint16_t *values, size_t n_values)
 {
-    return variance(values, n_values, mean);
+    return median_inplace(values, n_values);
 }
 
-double meani64v(const int64_t *values, size_t n_values)
+double mediani32v_inplace(int32_t *values, size_t n_values)
 {
-    return mean(values, n_values);
+    return median_inplace(values, n_values);
 }
 
-double mediani64v(const int64_t *values, size_t n_values)
+double medianu32v_inplace(uint32_t *values, size_t n_values)
 {
-    return median(values, n_values);
+    return median_inplace(values, n_values);
 }
 
-int64_t modei64v(const int64_t *values, size_t n_values, size_t *pfrequency)
+double mediani64v_inplace(int64_t *values, size_t n_values)
 {
-    return mode(values, n_values, pfrequency);
+    return median_inplace(values, n_values);
 }
 
-double variancei64v(const int64_t *values, size_t n_values, double mean)
+double medianu64v_inplace(uint64_t *values, size_t n_values)
 {
-    return variance(values, n_values, mean);
+    return median_inplace(values, n_values);
 }
 
-double meanu64v(const uint64_t *values, size_t n_values)
+double medianf32v_inplace(float *values, size_t n_values)
 {
-    return mean(values, n_values);
+    return median_inplace(values, n_values);
 }
 
-double medianu64v(const uint64_t *values, size_t n_values)
+double medianf64v_inplace(double *values, size_t n_values)
 {
-    return median(values, n_values);
+    return median_inplace(values, n_values);
 }
 
-uint64_t modeu64v(const uint64_t *values, size_t n_values, size_t *pfrequency)
+void summary7i8v_inplace(Summary7 *s7,
+                         int8_t *values, size_t n_values,
+                         enum summary7_fence fence)
 {
-    return mode(values, n_values, pfrequency);
+    summary7_inplace(s7, values, n_values, fence);
 }
 
-double varianceu64v(const uint64_t *values, size_t n_values, double mean)
+void summary7u8v_inplace(Summary7 *s7,
+                         uint8_t *values, size_t n_values,
+                         enum summary7_fence fence)
 {
-    return variance(values, n_values, mean);
+    summary7_inplace(s7, values, n_values, fence);
 }
 
-double meanf32v(const float *values, size_t n_values)
+void summary7i16v_inplace(Summary7 *s7,
+                          int16_t *values, size_t n_values,
+                          enum summary7_fence fence)
 {
-    return mean(values, n_values);
+    summary7_inplace(s7, values, n_values, fence);
 }
 
-double medianf32v(const float *values, size_t n_values)
+void summary7u16v_inplace(Summary7 *s7,
+                          uint16_t *values, size_t n_values,
+                          enum summary7_fence fence)
 {
-    return median(values, n_values);
+    summary7_inplace(s7, values, n_values, fence);
 }
 
-double variancef32v(const float *values, size_t n_values, double mean)
+void summary7i32v_inplace(Summary7 *s7,
+                          int32_t *values, size_t n_values,
+                          enum summary7_fence fence)
 {
-    return variance(values, n_values, mean);
+    summary7_inplace(s7, values, n_values, fence);
 }
 
-double meanf64v(const double *values, size_t n_values)
+void summary7u32v_inplace(Summary7 *s7,
+                          uint32_t *values, size_t n_values,
+                          enum summary7_fence fence)
 {
-    return mean(values, n_values);
+    summary7_inplace(s7, values, n_values, fence);
 }
 
-double medianf64v(const double *values, size_t n_values)
+void summary7i64v_inplace(Summary7 *s7,
+                          int64_t *values, size_t n_values,
+                          enum summary7_fence fence)
 {
-    return median(values, n_values);
+    summary7_inplace(s7, values, n_values, fence);
 }
 
-double variancef64v(const double *values, size_t n_values, double mean)
+void summary7u64v_inplace(Summary7 *s7,
+                          uint64_t *values, size_t n_values,
+                          enum summary7_fence fence)
 {
-    return variance(values, n_values, mean);
+    summary7_inplace(s7, values, n_values, fence);
 }
 
-void statsi8v(const int8_t *values, size_t n_values,
-              int8_t *pmin, size_t *pmin_frequency,
-              int8_t *pmax, size_t *pmax_frequency,
-              double *pmean, double *pvariance)
+void summary7f32v_inplace(Summary7 *s7,
+                          float *values, size_t n_values,
+                          enum summary7_fence fence)
+{
+    summary7_inplace(s7, values, n_values, fence);
+}
+
+void summary7f64v_inplace(Summary7 *s7,
+                          double *values, size_t n_values,
+                          enum summary7_fence fence)
+{
+    summary7_inplace(s7, values, n_values, fence);
+}
+
+int quantilesi8v(double *out,
+                 const int8_t *values, size_t n_values,
+                 const double *ps, size_t n_ps)
 {
-    return stats(values, n_values,
-                 pmin, pmin_frequency,
-                 pmax, pmax_frequency,
-                 pmean, pvariance);
+    return quantiles(out, values, n_values, ps, n_ps);
 }
 
-void statsu8v(const uint8_t *values, size_t n_values,
-              uint8_t *pmin, size_t *pmin_frequency,
-              uint8_t *pmax, size_t *pmax_frequency,
-              double *pmean, double *pvariance)
+int quantilesu8v(double *out,
+                 const uint8_t *values, size_t n_values,
+                 const double *ps, size_t n_ps)
 {
-    return stats(values, n_values,
-                 pmin, pmin_frequency,
-                 pmax, pmax_frequency,
-                 pmean, pvariance);
+    return quantiles(out, values, n_values, ps, n_ps);
 }
 
-void statsi16v(const int16_t *values, size_t n_values,
-               int16_t *pmin, size_t *pmin_frequency,
-               int16_t *pmax, size_t *pmax_frequency,
-               double *pmean, double *pvariance)
+int quantilesi16v(double *out,
+                  const int16_t *values, size_t n_values,
+                  const double *ps, size_t n_ps)
 {
-    return stats(values, n_values,
-                 pmin, pmin_frequency,
-                 pmax, pmax_frequency,
-                 pmean, pvariance);
+    return quantiles(out, values, n_values, ps, n_ps);
 }
 
-void statsu16v(const uint16_t *values, size_t n_values,
-               uint16_t *pmin, size_t *pmin_frequency,
-               uint16_t *pmax, size_t *pmax_frequency,
-               double *pmean, double *pvariance)
+int quantilesu16v(double *out,
+                  const uint16_t *values, size_t n_values,
+                  const double *ps, size_t n_ps)
 {
-    return stats(values, n_values,
-                 pmin, pmin_frequency,
-                 pmax, pmax_frequency,
-                 pmean, pvariance);
+    return quantiles(out, values, n_values, ps, n_ps);
 }
 
-void statsi32v(const int32_t *values, size_t n_values,
-               int32_t *pmin, size_t *pmin_frequency,
-               int32_t *pmax, size_t *pmax_frequency,
-               double *pmean, double *pvariance)
+int quantilesi32v(double *out,
+                  const int32_t *values, size_t n_values,
+                  const double *ps, size_t n_ps)
 {
-    return stats(values, n_values,
-                 pmin, pmin_frequency,
-                 pmax, pmax_frequency,
-                 pmean, pvariance);
+    return quantiles(out, values, n_values, ps, n_ps);
 }
 
-void statsu32v(const uint32_t *values, size_t n_values,
-               uint32_t *pmin, size_t *pmin_frequency,
-               uint32_t *pmax, size_t *pmax_frequency,
-               double *pmean, double *pvariance)
+int quantilesu32v(double *out,
+                  const uint32_t *values, size_t n_values,
+                  const double *ps, size_t n_ps)
 {
-    return stats(values, n_values,
-                 pmin, pmin_frequency,
-                 pmax, pmax_frequency,
-                 pmean, pvariance);
+    return quantiles(out, values, n_values, ps, n_ps);
 }
 
-void statsi64v(const int64_t *values, size_t n_values,
-               int64_t *pmin, size_t *pmin_frequency,
-               int64_t *pmax, size_t *pmax_frequency,
-               double *pmean, double *pvariance)
+int quantilesi64v(double *out,
+                  const int64_t *values, size_t n_values,
+                  const double *ps, size_t n_ps)
 {
-    return stats(values, n_values,
-                 pmin, pmin_frequency,
-                 pmax, pmax_frequency,
-                 pmean, pvariance);
+    return quantiles(out, values, n_values, ps, n_ps);
 }
 
-void statsu64v(const uint64_t *values, size_t n_values,
-               uint64_t *pmin, size_t *pmin_frequency,
-               uint64_t *pmax, size_t *pmax_frequency,
-               double *pmean, double *pvariance)
+int quantilesu64v(double *out,
+                  const uint64_t *values, size_t n_values,
+                  const double *ps, size_t n_ps)
 {
-    return stats(values, n_values,
-                 pmin, pmin_frequency,
-                 pmax, pmax_frequency,
-                 pmean, pvariance);
+    return quantiles(out, values, n_values, ps, n_ps);
 }
 
-void statsf32v(const float *values, size_t n_values,
-               float *pmin, size_t *pmin_frequency,
-               float *pmax, size_t *pmax_frequency,
-               double *pmean, double *pvariance)
+int quantilesf32v(double *out,
+                  const float *values, size_t n_values,
+                  const double *ps, size_t n_ps)
 {
-    return stats(values, n_values,
-                 pmin, pmin_frequency,
-                 pmax, pmax_frequency,
-                 pmean, pvariance);
+    return quantiles(out, values, n_values, ps, n_ps);
 }
 
-void statsf64v(const double *values, size_t n_values,
-               double *pmin, size_t *pmin_frequency,
-               double *pmax, size_t *pmax_frequency,
-               double *pmean, double *pvariance)
+int quantilesf64v(double *out,
+                  const double *values, size_t n_values,
+                  const double *ps, size_t n_ps)
 {
-    return stats(values, n_values,
-                 pmin, pmin_frequency,
-                 pmax, pmax_frequency,
-                 pmean, pvariance);
+    return quantiles(out, values, n_values, ps, n_ps);
 }
 
-int summary7i8v(Summary7 *s7,
-                const int8_t *values, size_t n_values,
-                enum summary7_fence fence)
+int quantilesi8v_inplace(double *out,
+                         int8_t *values, size_t n_values,
+                         const double *ps, size_t n_ps)
 {
-    return summary7(s7, values, n_values, fence);
+    return quantiles_inplace(out, values, n_values, ps, n_ps);
 }
 
-int summary7u8v(Summary7 *s7,
-                const uint8_t *values, size_t n_values,
-                enum summary7_fence fence)
+int quantilesu8v_inplace(double *out,
+                         uint8_t *values, size_t n_values,
+                         const double *ps, size_t n_ps)
 {
-    return summary7(s7, values, n_values, fence);
+    return quantiles_inplace(out, values, n_values, ps, n_ps);
 }
 
-int summary7i16v(Summary7 *s7,
-                 const int16_t *values, size_t n_values,
-                 enum summary7_fence fence)
+int quantilesi16v_inplace(double *out,
+                          int16_t *values, size_t n_values,
+                          const double *ps, size_t n_ps)
 {
-    return summary7(s7, values, n_values, fence);
+    return quantiles_inplace(out, values, n_values, ps, n_ps);
 }
 
-int summary7u16v(Summary7 *s7,
-                 const uint16_t *values, size_t n_values,
-                 enum summary7_fence fence)
+int quantilesu16v_inplace(double *out,
+                          uint16_t *values, size_t n_values,
+                          const double *ps, size_t n_ps)
 {
-    return summary7(s7, values, n_values, fence);
+    return quantiles_inplace(out, values, n_values, ps, n_ps);
 }
 
-int summary7i32v(Summary7 *s7,
-                 const int32_t *values, size_t n_values,
-                 enum summary7_fence fence)
+int quantilesi32v_inplace(double *out,
+                          int32_t *values, size_t n_values,
+                          const double *ps, size_t n_ps)
 {
-    return summary7(s7, values, n_values, fence);
+    return quantiles_inplace(out, values, n_values, ps, n_ps);
 }
 
-int summary7u32v(Summary7 *s7,
-                 const uint32_t *values, size_t n_values,
-                 enum summary7_fence fence)
+int quantilesu32v_inplace(double *out,
+                          uint32_t *values, size_t n_values,
+                          const double *ps, size_t n_ps)
 {
-    return summary7(s7, values, n_values, fence);
+    return quantiles_inplace(out, values, n_values, ps, n_ps);
 }
 
-int summary7i64v(Summary7 *s7,
-                 const int64_t *values, size_t n_values,
-                 enum summary7_fence fence)
+int quantilesi64v_inplace(double *out,
+                          int64_t *values, size_t n_values,
+                          const double *ps, size_t n_ps)
 {
-    return summary7(s7, values, n_values, fence);
+    return quantiles_inplace(out, values, n_values, ps, n_ps);
 }
 
-int summary7u64v(Summary7 *s7,
-                 const uint64_t *values, size_t n_values,
-                 enum summary7_fence fence)
+int quantilesu64v_inplace(double *out,
+                          uint64_t *values, size_t n_values,
+                          const double *ps, size_t n_ps)
 {
-    return summary7(s7, values, n_values, fence);
+    return quantiles_inplace(out, values, n_values, ps, n_ps);
 }
 
-int summary7f32v(Summary7 *s7,
-                 const float *values, size_t n_values,
-                 enum summary7_fence fence)
+int quantilesf32v_inplace(double *out,
+                          float *values, size_t n_values,
+                          const double *ps, size_t n_ps)
 {
-    return summary7(s7, values, n_values, fence);
+    return quantiles_inplace(out, values, n_values, ps, n_ps);
 }
 
-int summary7f64v(Summary7 *s7,
-                 const double *values, size_t n_values,
-                 enum summary7_fence fence)
+int quantilesf64v_inplace(double *out,
+                          double *values, size_t n_values,
+                          const double *ps, size_t n_ps)
 {
-    return summary7(s7, values, n_values, fence);
+    return quantiles_inplace(out, values, n_values, ps, n_ps);
 }
 
 void histogram_freqi8v(Histogram *hist, const char *title,
@@ -926,4 +3696,369 @@ void histogram_freqf64v(Histogram *hist, const char *title,
     histogram_freq(hist, title, values, n_values, thresholds, n_thresholds);
 }
 
+void histogram_freqi8v_parallel(Histogram *hist, const char *title,
+                                const int8_t *values, size_t n_values,
+                                const int8_t *thresholds,
+                                size_t n_thresholds,
+                                unsigned n_threads)
+{
+    histogram_freq(hist, title, values, n_values, thresholds, n_thresholds,
+                   n_threads);
+}
+
+void histogram_frequ8v_parallel(Histogram *hist, const char *title,
+                                const uint8_t *values, size_t n_values,
+                                const uint8_t *thresholds,
+                                size_t n_thresholds,
+                                unsigned n_threads)
+{
+    histogram_freq(hist, title, values, n_values, thresholds, n_thresholds,
+                   n_threads);
+}
+
+void histogram_freqi16v_parallel(Histogram *hist, const char *title,
+                                 const int16_t *values, size_t n_values,
+                                 const int16_t *thresholds,
+                                 size_t n_thresholds,
+                                 unsigned n_threads)
+{
+    histogram_freq(hist, title, values, n_values, thresholds, n_thresholds,
+                   n_threads);
+}
+
+void histogram_frequ16v_parallel(Histogram *hist, const char *title,
+                                 const uint16_t *values, size_t n_values,
+                                 const uint16_t *thresholds,
+                                 size_t n_thresholds,
+                                 unsigned n_threads)
+{
+    histogram_freq(hist, title, values, n_values, thresholds, n_thresholds,
+                   n_threads);
+}
+
+void histogram_freqi32v_parallel(Histogram *hist, const char *title,
+                                 const int32_t *values, size_t n_values,
+                                 const int32_t *thresholds,
+                                 size_t n_thresholds,
+                                 unsigned n_threads)
+{
+    histogram_freq(hist, title, values, n_values, thresholds, n_thresholds,
+                   n_threads);
+}
+
+void histogram_frequ32v_parallel(Histogram *hist, const char *title,
+                                 const uint32_t *values, size_t n_values,
+                                 const uint32_t *thresholds,
+                                 size_t n_thresholds,
+                                 unsigned n_threads)
+{
+    histogram_freq(hist, title, values, n_values, thresholds, n_thresholds,
+                   n_threads);
+}
+
+void histogram_freqi64v_parallel(Histogram *hist, const char *title,
+                                 const int64_t *values, size_t n_values,
+                                 const int64_t *thresholds,
+                                 size_t n_thresholds,
+                                 unsigned n_threads)
+{
+    histogram_freq(hist, title, values, n_values, thresholds, n_thresholds,
+                   n_threads);
+}
+
+void histogram_frequ64v_parallel(Histogram *hist, const char *title,
+                                 const uint64_t *values, size_t n_values,
+                                 const uint64_t *thresholds,
+                                 size_t n_thresholds,
+                                 unsigned n_threads)
+{
+    histogram_freq(hist, title, values, n_values, thresholds, n_thresholds,
+                   n_threads);
+}
+
+void histogram_freqf32v_parallel(Histogram *hist, const char *title,
+                                 const float *values, size_t n_values,
+                                 const float *thresholds,
+                                 size_t n_thresholds,
+                                 unsigned n_threads)
+{
+    histogram_freq(hist, title, values, n_values, thresholds, n_thresholds,
+                   n_threads);
+}
+
+void histogram_freqf64v_parallel(Histogram *hist, const char *title,
+                                 const double *values, size_t n_values,
+                                 const double *thresholds,
+                                 size_t n_thresholds,
+                                 unsigned n_threads)
+{
+    histogram_freq(hist, title, values, n_values, thresholds, n_thresholds,
+                   n_threads);
+}
+
+int qsketch_init(struct qsketch *qs, double alpha, size_t max_buckets)
+{
+    *qs = {};
+
+    if (!(alpha >= QSKETCH_MIN_ALPHA && alpha < 1.0)) return -1;
+
+    qs->alpha = alpha;
+    qs->ln_gamma = statsutil_log((1.0 + alpha) / (1.0 - alpha));
+    qs->max_buckets = max_buckets ? max_buckets : QSKETCH_DEFAULT_MAX_BUCKETS;
+    qs->min = qs->max = statsutil_nan;
+    return 0;
+}
+
+void qsketch_fini(struct qsketch *qs)
+{
+    statsutil_free(qs->neg.counts);
+    statsutil_free(qs->pos.counts);
+    *qs = {};
+}
+
+int qsketch_insert(struct qsketch *qs, double value)
+{
+    if (value != value) return 0;
+
+    if (value == 0.0) {
+        qs->n_zero ++;
+    }
+    else {
+        struct qsketch_store *st = value < 0.0 ? &qs->neg : &qs->pos;
+        const int32_t key = qsketch_key(qs, value < 0.0 ? -value : value);
+
+        if (!qsketch_cover(st, qs->max_buckets, key, key)) return -1;
+        qsketch_add(st, key, 1);
+    }
+
+    qsketch_extremes(qs, value, value, 1);
+    return 0;
+}
+
+int qsketch_insertv(struct qsketch *qs, const double *values, size_t n_values)
+{
+    size_t i;
+
+    for (i = 0; i < n_values; i++) {
+        if (qsketch_insert(qs, values[i])) return -1;
+    }
+    return 0;
+}
+
+int qsketch_merge(struct qsketch *qs, const struct qsketch *other)
+{
+    const struct qsketch_store *const others[] = { &other->neg, &other->pos };
+    struct qsketch_store *const stores[] = { &qs->neg, &qs->pos };
+    const size_t n_values = other->n_values;
+    size_t s, i;
+
+    if (other->alpha != qs->alpha) return -1;
+    if (!n_values) return 0;
+
+    /* make room in both first, so a failure leaves qs as it was */
+    for (s = 0; s < 2; s++) {
+        const struct qsketch_store *o = others[s];
+
+        if (o->n_buckets
+            && !qsketch_cover(stores[s], qs->max_buckets, o->offset,
+                              o->offset + (int64_t) o->n_buckets - 1))
+            return -1;
+    }
+
+    for (s = 0; s < 2; s++) {
+        const struct qsketch_store *o = others[s];
+
+        for (i = 0; i < o->n_buckets; i++)
+            qsketch_add(stores[s], o->offset + (int64_t) i, o->counts[i]);
+    }
+    qs->n_zero += other->n_zero;
+    qsketch_extremes(qs, other->min, other->max, n_values);
+    return 0;
+}
+
+void qsketch_quantiles(double *out, const struct qsketch *qs,
+                       const double *ps, size_t n_ps)
+{
+    const sketched_values sorted = { qs };
+    size_t i;
+
+    for (i = 0; i < n_ps; i++) {
+        out[i] = qs->n_values ? percentile(sorted, qs->n_values, ps[i])
+                              : statsutil_nan;
+    }
+}
+
+void qsketch_summary7(Summary7 *s7, const struct qsketch *qs,
+                      enum summary7_fence fence)
+{
+    hard_assert(fence >= FENCE_IQR15 && fence <= FENCE_PERC2);
+
+    summary7_sorted(s7, sketched_values{ qs }, qs->n_values, fence);
+}
+
+size_t qsketch_serialize(const struct qsketch *qs,
+                         void *buf, size_t buf_size)
+{
+    const size_t size = sizeof(struct qsketch_header)
+                        + (qs->neg.n_buckets + qs->pos.n_buckets)
+                          * sizeof(uint64_t);
+    struct qsketch_header h = {
+        .magic = {},
+        .version = 1,
+        .alpha = qs->alpha,
+        .max_buckets = qs->max_buckets,
+        .n_values = qs->n_values,
+        .n_zero = qs->n_zero,
+        .min = qs->min,
+        .max = qs->max,
+        .neg_offset = qs->neg.offset,
+        .neg_n_buckets = static_cast<uint32_t>(qs->neg.n_buckets),
+        .pos_offset = qs->pos.offset,
+        .pos_n_buckets = static_cast<uint32_t>(qs->pos.n_buckets),
+    };
+    unsigned char *p = static_cast<unsigned char *>(buf);
+
+    if (buf_size < size) return size;
+
+    __builtin_memcpy(h.magic, qsketch_magic, sizeof(h.magic));
+    __builtin_memcpy(p, &h, sizeof(h));
+    p = qsketch_write_store(p + sizeof(h), &qs->neg);
+    qsketch_write_store(p, &qs->pos);
+    return size;
+}
+
+int qsketch_deserialize(struct qsketch *qs, const void *buf, size_t buf_size)
+{
+    const unsigned char *p = static_cast<const unsigned char *>(buf);
+    struct qsketch_header h;
+    size_t total = 0;
+
+    *qs = {};
+
+    if (buf_size < sizeof(h)) return -1;
+    __builtin_memcpy(&h, p, sizeof(h));
+    p += sizeof(h);
+
+    if (__builtin_memcmp(h.magic, qsketch_magic, sizeof(h.magic))
+        || h.version != 1
+        || buf_size != sizeof(h) + ((size_t) h.neg_n_buckets
+                                    + h.pos_n_buckets) * sizeof(uint64_t)
+        || qsketch_init(qs, h.alpha, h.max_buckets)
+        || h.neg_n_buckets > qs->max_buckets
+        || h.pos_n_buckets > qs->max_buckets)
+        return -1;
+
+    p = qsketch_read_store(p, &qs->neg, h.neg_offset, h.neg_n_buckets,
+                           &total);
+    if (p) p = qsketch_read_store(p, &qs->pos, h.pos_offset, h.pos_n_buckets,
+                                  &total);
+    if (!p || total + h.n_zero != h.n_values) {
+        qsketch_fini(qs);
+        return -1;
+    }
+
+    qs->n_values = h.n_values;
+    qs->n_zero = h.n_zero;
+    qs->min = h.min;
+    qs->max = h.max;
+    return 0;
+}
+
+int hdrhist_init(struct hdrhist *h, unsigned sub_bits)
+{
+    *h = {};
+
+    if (sub_bits < 1 || sub_bits > HDRHIST_MAX_SUB_BITS) return -1;
+
+    h->sub_bits = sub_bits;
+    h->n_counts = (std::size_t) (65 - sub_bits) << sub_bits;
+    h->counts = static_cast<uint64_t *>(statsutil_calloc(h->n_counts,
+                                                         sizeof(h->counts[0])));
+    if (!h->counts) return -1;
+
+    h->min = UINT64_MAX;
+    return 0;
+}
+
+void hdrhist_fini(struct hdrhist *h)
+{
+    statsutil_free(h->counts);
+    *h = {};
+}
+
+void hdrhist_reset(struct hdrhist *h)
+{
+    memset(h->counts, 0, h->n_counts * sizeof(h->counts[0]));
+    h->n_values = 0;
+    h->min = UINT64_MAX;
+    h->max = 0;
+}
+
+int hdrhist_merge(struct hdrhist *h, const struct hdrhist *other)
+{
+    size_t i;
+
+    if (other->sub_bits != h->sub_bits) return -1;
+
+    for (i = 0; i < h->n_counts; i++)
+        h->counts[i] += other->counts[i];
+    h->n_values += other->n_values;
+    h->min = std::min(h->min, other->min);
+    h->max = std::max(h->max, other->max);
+    return 0;
+}
+
+double hdrhist_percentile(const struct hdrhist *h, double p)
+{
+    if (!h->n_values) return statsutil_nan;
+
+    return percentile(hdrhist_values{ h }, h->n_values, p);
+}
+
+void hdrhist_quantiles(double *out, const struct hdrhist *h,
+                       const double *ps, size_t n_ps)
+{
+    size_t i;
+
+    for (i = 0; i < n_ps; i++)
+        out[i] = hdrhist_percentile(h, ps[i]);
+}
+
+void hdrhist_summary7(Summary7 *s7, const struct hdrhist *h,
+                      enum summary7_fence fence)
+{
+    hard_assert(fence >= FENCE_IQR15 && fence <= FENCE_PERC2);
+
+    summary7_sorted(s7, hdrhist_values{ h }, h->n_values, fence);
+}
+
+void hdrhist_histogram(Histogram *hist, const char *title,
+                       const struct hdrhist *h,
+                       const uint64_t *thresholds, size_t n_thresholds)
+{
+    uint64_t *freeme = NULL;
+
+    if (!thresholds) {
+        const uint64_t extremes[] = { h->min, h->max };
+
+        thresholds = freeme = invent_thresholds(extremes,
+                                                h->n_values ? 2 : 0,
+                                                &n_thresholds);
+    }
+
+    histogram_init(hist, title, n_thresholds);
+
+    hdrhist_walk(h, [&](double v, std::size_t count) {
+        const std::size_t t = std::upper_bound(thresholds,
+                                               thresholds + n_thresholds,
+                                               v) - thresholds;
+
+        hist->buckets[t].freq_raw += count;
+        return false;
+    });
+
+    histogram_finish(hist, thresholds, n_thresholds, h->n_values);
+    statsutil_free(freeme);
+}
+
 } /* extern "C" */
@@ -20,26 +20,8 @@ See <http://creativecommons.org/publicdomain/zero/1.0/>. */
 
 #include "flrl/xoshiro.h"
 
-static inline uint32_t rotl(const uint32_t x, int k) {
-    return (x << k) | (x >> (32 - k));
-}
-
-
 uint32_t xoshiro128plusplus_next(struct state128 *state) {
-    const uint32_t result = rotl(state->s[0] + state->s[3], 7) + state->s[0];
-
-    const uint32_t t = state->s[1] << 9;
-
-    state->s[2] ^= state->s[0];
-    state->s[3] ^= state->s[1];
-    state->s[1] ^= state->s[2];
-    state->s[0] ^= state->s[3];
-
-    state->s[2] ^= t;
-
-    state->s[3] = rotl(state->s[3], 11);
-
-    return result;
+    return xoshiro128plusplus_next_inline(state);
 }
 
 
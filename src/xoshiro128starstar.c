@@ -23,26 +23,8 @@ See <http://creativecommons.org/publicdomain/zero/1.0/>. */
 
 #include "flrl/xoshiro.h"
 
-static inline uint32_t rotl(const uint32_t x, int k) {
-    return (x << k) | (x >> (32 - k));
-}
-
-
 uint32_t xoshiro128starstar_next(struct state128 *state) {
-    const uint32_t result = rotl(state->s[1] * 5, 7) * 9;
-
-    const uint32_t t = state->s[1] << 9;
-
-    state->s[2] ^= state->s[0];
-    state->s[3] ^= state->s[1];
-    state->s[1] ^= state->s[2];
-    state->s[0] ^= state->s[3];
-
-    state->s[2] ^= t;
-
-    state->s[3] = rotl(state->s[3], 11);
-
-    return result;
+    return xoshiro128starstar_next_inline(state);
 }
 
 
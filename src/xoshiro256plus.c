@@ -25,26 +25,8 @@ See <http://creativecommons.org/publicdomain/zero/1.0/>. */
 
 #include "flrl/xoshiro.h"
 
-static inline uint64_t rotl(const uint64_t x, int k) {
-    return (x << k) | (x >> (64 - k));
-}
-
-
 uint64_t xoshiro256plus_next(struct state256 *state) {
-    const uint64_t result = state->s[0] + state->s[3];
-
-    const uint64_t t = state->s[1] << 17;
-
-    state->s[2] ^= state->s[0];
-    state->s[3] ^= state->s[1];
-    state->s[1] ^= state->s[2];
-    state->s[0] ^= state->s[3];
-
-    state->s[2] ^= t;
-
-    state->s[3] = rotl(state->s[3], 45);
-
-    return result;
+    return xoshiro256plus_next_inline(state);
 }
 
 